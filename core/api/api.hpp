@@ -26,6 +26,7 @@
 #include "vm/actor/builtin/miner/types.hpp"
 #include "vm/actor/builtin/payment_channel/payment_channel_actor_state.hpp"
 #include "vm/actor/builtin/storage_power/storage_power_actor_state.hpp"
+#include "vm/runtime/profiler.hpp"
 #include "vm/runtime/runtime_types.hpp"
 
 #define API_METHOD(_name, _result, ...)                                    \
@@ -89,6 +90,8 @@ namespace fc::api {
   using vm::message::UnsignedMessage;
   using vm::runtime::ExecutionResult;
   using vm::runtime::MessageReceipt;
+  using vm::runtime::MethodProfile;
+  using vm::runtime::TipsetProfile;
   using SignatureType = crypto::signature::Type;
 
   template <typename... T>
@@ -204,6 +207,13 @@ namespace fc::api {
     uint64_t block_delay;
   };
 
+  struct VmProfileResult {
+    std::vector<MethodProfile> methods;
+    std::vector<TipsetProfile> tipsets;
+    /// Folded stacks for flamegraph
+    std::string flamegraph;
+  };
+
   struct MiningBaseInfo {
     StoragePower miner_power;
     StoragePower network_power;
@@ -449,6 +459,9 @@ namespace fc::api {
 
     API_METHOD(Version, VersionResult)
 
+    /** VM profile collected when node runs with VM_PROFILE set */
+    API_METHOD(VmProfile, VmProfileResult)
+
     /** Wallet */
     API_METHOD(WalletBalance, TokenAmount, const Address &)
     API_METHOD(WalletDefaultAddress, Address)
@@ -8,6 +8,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include "codec/cbor/cbor_resolve.hpp"
+#include "storage/ipld/resolve.hpp"
 
 namespace fc::api {
   using boost::starts_with;
@@ -64,18 +65,9 @@ namespace fc::api {
         } else {
           OUTCOME_TRY(codec::cbor::resolve(s, part));
         }
-        if (s.isCid()) {
-          auto s2 = s;
-          CID cid;
-          s2 >> cid;
-          if (cid.content_type == libp2p::multi::MulticodecType::DAG_CBOR) {
-            OUTCOME_TRY(raw2, ipld->get(cid));
-            s = CborDecodeStream{raw2};
-          } else {
-            if (i != parts.size() - 1) {
-              return TodoError::kError;
-            }
-          }
+        OUTCOME_TRY(followed, storage::ipld::followLink(*ipld, s));
+        if (!followed && s.isCid() && i != parts.size() - 1) {
+          return TodoError::kError;
         }
       }
       raw = Buffer{s.raw()};
@@ -14,6 +14,7 @@
 #include "node/pubsub.hpp"
 #include "proofs/proofs.hpp"
 #include "storage/hamt/hamt.hpp"
+#include "storage/ipfs/impl/overlay_datastore.hpp"
 #include "vm/actor/builtin/account/account_actor.hpp"
 #include "vm/actor/builtin/init/init_actor.hpp"
 #include "vm/actor/builtin/market/actor.hpp"
@@ -164,10 +165,12 @@ namespace fc::api {
                std::shared_ptr<Mpool> mpool,
                std::shared_ptr<Interpreter> interpreter,
                std::shared_ptr<MsgWaiter> msg_waiter,
+               std::shared_ptr<HeightIndex> height_index,
                std::shared_ptr<Beaconizer> beaconizer,
                std::shared_ptr<DrandSchedule> drand_schedule,
                std::shared_ptr<PubSub> pubsub,
                std::shared_ptr<KeyStore> key_store) {
+    auto overlays{storage::ipfs::OverlayPool::make(ipld)};
     auto tipsetContext = [=](const TipsetKey &tipset_key,
                              bool interpret =
                                  false) -> outcome::result<TipsetContext> {
@@ -189,7 +192,9 @@ namespace fc::api {
         [=](auto tipset, auto epoch) -> outcome::result<TipsetContext> {
       auto lookback{
           std::max(ChainEpoch{0}, epoch - kWinningPoStSectorSetLookback)};
-      while (tipset->height() > static_cast<uint64_t>(lookback)) {
+      OUTCOME_TRYA(tipset, height_index->lookup(tipset, lookback));
+      // lookback is null round
+      if (tipset->height() > static_cast<uint64_t>(lookback)) {
         OUTCOME_TRYA(tipset, tipset->loadParent(*ipld));
       }
       OUTCOME_TRY(result, interpreter->interpret(ipld, tipset));
@@ -298,7 +303,6 @@ namespace fc::api {
         }},
         .ChainGetTipSetByHeight = {[=](auto height2, auto &tipset_key)
                                        -> outcome::result<TipsetCPtr> {
-          // TODO(turuslan): use height index from chain store
           // TODO(turuslan): return genesis if height is zero
           auto height = static_cast<uint64_t>(height2);
           OUTCOME_TRY(context, tipsetContext(tipset_key));
@@ -306,14 +310,7 @@ namespace fc::api {
           if (tipset->height() < height) {
             return TodoError::kError;
           }
-          while (tipset->height() > height) {
-            OUTCOME_TRY(parent, tipset->loadParent(*ipld));
-            if (parent->height() < height) {
-              break;
-            }
-            tipset = std::move(parent);
-          }
-          return std::move(tipset);
+          return height_index->lookup(tipset, height);
         }},
         .ChainHead = {[=]() { return chain_store->heaviestTipset(); }},
         .ChainNotify = {[=]() {
@@ -356,7 +353,10 @@ namespace fc::api {
           OUTCOME_TRY(miner_state, context.minerState(t.miner));
           OUTCOME_TRY(block,
                       blockchain::production::generate(
-                          *interpreter, ipld, std::move(t)));
+                          *interpreter,
+                          *weight_calculator,
+                          ipld,
+                          std::move(t)));
 
           OUTCOME_TRY(block_signable, codec::cbor::encode(block.header));
           OUTCOME_TRY(minfo, miner_state.info.get());
@@ -473,8 +473,10 @@ namespace fc::api {
         .StateCall = {[=](auto &message,
                           auto &tipset_key) -> outcome::result<InvocResult> {
           OUTCOME_TRY(context, tipsetContext(tipset_key));
+          auto overlay{
+              overlays->acquire(context.tipset->getParentStateRoot())};
           auto env = std::make_shared<Env>(
-              std::make_shared<InvokerImpl>(), ipld, context.tipset);
+              std::make_shared<InvokerImpl>(), overlay, context.tipset);
           InvocResult result;
           result.message = message;
           OUTCOME_TRYA(result.receipt, env->applyImplicitMessage(message));
@@ -560,11 +562,11 @@ namespace fc::api {
         .StateGetReceipt = {[=](auto &cid, auto &tipset_key)
                                 -> outcome::result<MessageReceipt> {
           OUTCOME_TRY(context, tipsetContext(tipset_key));
-          auto result{msg_waiter->results.find(cid)};
-          if (result != msg_waiter->results.end()) {
-            OUTCOME_TRY(ts, Tipset::load(*ipld, result->second.second.cids()));
+          OUTCOME_TRY(result, msg_waiter->search(cid));
+          if (result) {
+            OUTCOME_TRY(ts, Tipset::load(*ipld, result->second.cids()));
             if (context.tipset->height() <= ts->height()) {
-              return result->second.first;
+              return result->first;
             }
           }
           return TodoError::kError;
@@ -720,7 +722,16 @@ namespace fc::api {
         // TODO(artyom-yurin): FIL-165 implement method
         .StateSectorPartition = {},
         // TODO(artyom-yurin): FIL-165 implement method
-        .StateSearchMsg = {},
+        .StateSearchMsg = {[=](auto &cid)
+                               -> outcome::result<boost::optional<MsgWait>> {
+          OUTCOME_TRY(result, msg_waiter->search(cid));
+          if (!result) {
+            return boost::none;
+          }
+          OUTCOME_TRY(ts, Tipset::load(*ipld, result->second.cids()));
+          return MsgWait{
+              cid, result->first, ts->key, (ChainEpoch)ts->height()};
+        }},
         .StateWaitMsg = waitCb<MsgWait>([=](auto &&cid,
                                             auto &&confidence,
                                             auto &&cb) {
@@ -750,6 +761,15 @@ namespace fc::api {
         .Version = {[]() {
           return VersionResult{"fuhon", 0x000C00, 5};
         }},
+        .VmProfile = {[]() -> outcome::result<VmProfileResult> {
+          auto &profiler{vm::runtime::profiler};
+          if (!profiler) {
+            return vm::runtime::ProfilerError::kDisabled;
+          }
+          return VmProfileResult{profiler->methods(),
+                                 profiler->tipsets(),
+                                 profiler->flamegraph()};
+        }},
         .WalletBalance = {[=](auto &address) -> outcome::result<TokenAmount> {
           OUTCOME_TRY(context, tipsetContext({}));
           OUTCOME_TRY(actor, context.state_tree.get(address));
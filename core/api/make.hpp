@@ -12,6 +12,7 @@
 #include "common/todo_error.hpp"
 #include "node/fwd.hpp"
 #include "storage/chain/chain_store.hpp"
+#include "storage/chain/height_index.hpp"
 #include "storage/chain/msg_waiter.hpp"
 #include "storage/keystore/keystore.hpp"
 #include "storage/mpool/mpool.hpp"
@@ -24,6 +25,7 @@ namespace fc::api {
   using drand::DrandSchedule;
   using pubsub::PubSub;
   using storage::blockchain::ChainStore;
+  using storage::blockchain::HeightIndex;
   using storage::blockchain::MsgWaiter;
   using storage::keystore::KeyStore;
   using storage::mpool::Mpool;
@@ -40,6 +42,7 @@ namespace fc::api {
                std::shared_ptr<Mpool> mpool,
                std::shared_ptr<Interpreter> interpreter,
                std::shared_ptr<MsgWaiter> msg_waiter,
+               std::shared_ptr<HeightIndex> height_index,
                std::shared_ptr<Beaconizer> beaconizer,
                std::shared_ptr<DrandSchedule> drand_schedule,
                std::shared_ptr<PubSub> pubsub,
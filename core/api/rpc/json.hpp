@@ -58,6 +58,8 @@ namespace fc::api {
   using vm::actor::builtin::miner::WorkerKeyChange;
   using vm::actor::builtin::payment_channel::Merge;
   using vm::actor::builtin::payment_channel::ModularVerificationParameter;
+  using vm::runtime::MessageProfile;
+  using vm::runtime::ProfileStats;
   using base64 = cppcodec::base64_rfc4648;
 
   struct Codec {
@@ -1234,6 +1236,89 @@ namespace fc::api {
       Get(j, "BlockDelay", v.block_delay);
     }
 
+    ENCODE(ProfileStats) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Calls", v.calls);
+      Set(j, "Time", static_cast<int64_t>(v.time.count()));
+      Set(j, "SelfTime", static_cast<int64_t>(v.self_time.count()));
+      Set(j, "Gas", v.gas);
+      Set(j, "Gets", v.gets);
+      Set(j, "GetBytes", v.get_bytes);
+      Set(j, "Puts", v.puts);
+      Set(j, "PutBytes", v.put_bytes);
+      return j;
+    }
+
+    DECODE(ProfileStats) {
+      Get(j, "Calls", v.calls);
+      v.time = std::chrono::nanoseconds{decode<int64_t>(Get(j, "Time"))};
+      v.self_time =
+          std::chrono::nanoseconds{decode<int64_t>(Get(j, "SelfTime"))};
+      Get(j, "Gas", v.gas);
+      Get(j, "Gets", v.gets);
+      Get(j, "GetBytes", v.get_bytes);
+      Get(j, "Puts", v.puts);
+      Get(j, "PutBytes", v.put_bytes);
+    }
+
+    ENCODE(MethodProfile) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Code", v.code);
+      Set(j, "Method", v.method);
+      Set(j, "Stats", v.stats);
+      return j;
+    }
+
+    DECODE(MethodProfile) {
+      Get(j, "Code", v.code);
+      Get(j, "Method", v.method);
+      Get(j, "Stats", v.stats);
+    }
+
+    ENCODE(MessageProfile) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "From", v.from);
+      Set(j, "To", v.to);
+      Set(j, "Method", v.method);
+      Set(j, "Stats", v.stats);
+      return j;
+    }
+
+    DECODE(MessageProfile) {
+      Get(j, "From", v.from);
+      Get(j, "To", v.to);
+      Get(j, "Method", v.method);
+      Get(j, "Stats", v.stats);
+    }
+
+    ENCODE(TipsetProfile) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Height", v.height);
+      Set(j, "Stats", v.stats);
+      Set(j, "Messages", v.messages);
+      return j;
+    }
+
+    DECODE(TipsetProfile) {
+      Get(j, "Height", v.height);
+      Get(j, "Stats", v.stats);
+      Get(j, "Messages", v.messages);
+    }
+
+    ENCODE(VmProfileResult) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Methods", v.methods);
+      Set(j, "Tipsets", v.tipsets);
+      Set(j, "Flamegraph", v.flamegraph);
+      return j;
+    }
+
+    DECODE(VmProfileResult) {
+      Get(j, "Methods", v.methods);
+      Get(j, "Tipsets", v.tipsets);
+      Get(j, "Flamegraph", v.flamegraph);
+    }
+
     ENCODE(MiningBaseInfo) {
       Value j{rapidjson::kObjectType};
       Set(j, "MinerPower", v.miner_power);
@@ -75,6 +75,7 @@ namespace fc::api {
     f(a.StateWaitMsg);
     f(a.SyncSubmitBlock);
     f(a.Version);
+    f(a.VmProfile);
     f(a.WalletBalance);
     f(a.WalletDefaultAddress);
     f(a.WalletHas);
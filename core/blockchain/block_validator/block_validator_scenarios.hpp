@@ -16,7 +16,8 @@ namespace fc::blockchain::block_validator::scenarios {
     BLOCK_SIGNATURE_BV2,
     ELECTION_POST_BV3,
     MESSAGE_SIGNATURE_BV4,
-    STATE_TREE_BV5
+    STATE_TREE_BV5,
+    BLS_AGGREGATE_BV6
   };
 
   /**
@@ -32,6 +33,7 @@ namespace fc::blockchain::block_validator::scenarios {
                                  Stage::BLOCK_SIGNATURE_BV2,
                                  Stage::ELECTION_POST_BV3,
                                  Stage::MESSAGE_SIGNATURE_BV4,
+                                 Stage::BLS_AGGREGATE_BV6,
                                  Stage::STATE_TREE_BV5};
 
 }  // namespace fc::blockchain::block_validator::scenarios
@@ -10,9 +10,11 @@
 #include "codec/cbor/cbor.hpp"
 #include "storage/amt/amt.hpp"
 #include "storage/ipld/ipld_block.hpp"
+#include "vm/runtime/env.hpp"
 
 namespace fc::blockchain::block_validator {
   using primitives::address::Protocol;
+  using primitives::block::MsgMeta;
   using storage::amt::Amt;
   using SignedMessage = vm::message::SignedMessage;
   using UnsignedMessage = vm::message::UnsignedMessage;
@@ -29,6 +31,7 @@ namespace fc::blockchain::block_validator {
           {Stage::BLOCK_SIGNATURE_BV2, &BlockValidatorImpl::blockSign},
           {Stage::ELECTION_POST_BV3, &BlockValidatorImpl::electionPost},
           {Stage::MESSAGE_SIGNATURE_BV4, &BlockValidatorImpl::messageSign},
+          {Stage::BLS_AGGREGATE_BV6, &BlockValidatorImpl::blsAggregate},
           {Stage::STATE_TREE_BV5, &BlockValidatorImpl::stateTree}};
 
   outcome::result<void> BlockValidatorImpl::validateBlock(
@@ -134,6 +137,39 @@ namespace fc::blockchain::block_validator {
 
   outcome::result<void> BlockValidatorImpl::messageSign(
       const BlockHeader &block) const {
+    OUTCOME_TRY(meta, datastore_->getCbor<MsgMeta>(block.messages));
+    auto resolve{
+        vm::runtime::keyResolver(datastore_, block.parent_state_root)};
+    std::vector<SignatureVerifier::Item> items;
+    auto unresolved{false};
+    OUTCOME_TRY(meta.secp_messages.visit(
+        [&](auto, auto &cid) -> outcome::result<void> {
+          OUTCOME_TRY(message, datastore_->getCbor<SignedMessage>(cid));
+          OUTCOME_TRY(item, SignatureVerifier::item(message, resolve));
+          if (item) {
+            items.push_back(std::move(*item));
+          } else {
+            unresolved = true;
+          }
+          return outcome::success();
+        }));
+    // sender must be account in parent state
+    if (unresolved) {
+      return ValidatorError::kInvalidMessageSignature;
+    }
+    auto valid{signature_verifier_->verify(items)};
+    if (std::find(valid.begin(), valid.end(), false) != valid.end()) {
+      return ValidatorError::kInvalidMessageSignature;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> BlockValidatorImpl::blsAggregate(
+      const BlockHeader &block) const {
+    OUTCOME_TRY(item, BlsAggregateVerifier::item(datastore_, block));
+    if (!bls_aggregate_verifier_->verify(item).valid) {
+      return ValidatorError::kInvalidBlsAggregate;
+    }
     return outcome::success();
   }
 
@@ -194,6 +230,10 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::block_validator,
       return "Block validation: invalid miner public key";
     case ValidatorError::kInvalidParentState:
       return "Block validation: invalid parent state";
+    case ValidatorError::kInvalidMessageSignature:
+      return "Block validation: invalid message signature";
+    case ValidatorError::kInvalidBlsAggregate:
+      return "Block validation: invalid bls aggregate signature";
   }
   return "Block validation: unknown error";
 }
@@ -13,6 +13,7 @@
 #include <boost/optional.hpp>
 #include <libp2p/crypto/secp256k1_provider.hpp>
 #include "blockchain/block_validator/block_validator.hpp"
+#include "blockchain/block_validator/impl/bls_aggregate_verifier.hpp"
 #include "blockchain/weight_calculator.hpp"
 #include "clock/chain_epoch_clock.hpp"
 #include "clock/utc_clock.hpp"
@@ -20,6 +21,7 @@
 #include "power/power_table.hpp"
 #include "storage/ipfs/datastore.hpp"
 #include "vm/interpreter/interpreter.hpp"
+#include "vm/message/signature_verifier.hpp"
 
 namespace fc::blockchain::block_validator {
 
@@ -34,6 +36,7 @@ namespace fc::blockchain::block_validator {
     using BlsProvider = crypto::bls::BlsProvider;
     using SecpProvider = crypto::secp256k1::Secp256k1ProviderDefault;
     using Interpreter = vm::interpreter::Interpreter;
+    using SignatureVerifier = vm::message::SignatureVerifier;
     using Tipset = primitives::tipset::Tipset;
     using TipsetCPtr = primitives::tipset::TipsetCPtr;
 
@@ -48,7 +51,10 @@ namespace fc::blockchain::block_validator {
                        std::shared_ptr<PowerTable> power_table,
                        std::shared_ptr<BlsProvider> bls_crypto_provider,
                        std::shared_ptr<SecpProvider> secp_crypto_provider,
-                       std::shared_ptr<Interpreter> vm_interpreter)
+                       std::shared_ptr<Interpreter> vm_interpreter,
+                       std::shared_ptr<SignatureVerifier> signature_verifier,
+                       std::shared_ptr<BlsAggregateVerifier>
+                           bls_aggregate_verifier)
         : datastore_{std::move(ipfs_store)},
           clock_{std::move(utc_clock)},
           epoch_clock_{std::move(epoch_clock)},
@@ -56,7 +62,9 @@ namespace fc::blockchain::block_validator {
           power_table_{std::move(power_table)},
           bls_provider_{std::move(bls_crypto_provider)},
           secp_provider_{std::move(secp_crypto_provider)},
-          vm_interpreter_{std::move(vm_interpreter)} {}
+          vm_interpreter_{std::move(vm_interpreter)},
+          signature_verifier_{std::move(signature_verifier)},
+          bls_aggregate_verifier_{std::move(bls_aggregate_verifier)} {}
 
     outcome::result<void> validateBlock(
         const BlockHeader &header, scenarios::Scenario scenario) const override;
@@ -72,6 +80,8 @@ namespace fc::blockchain::block_validator {
     std::shared_ptr<BlsProvider> bls_provider_;
     std::shared_ptr<SecpProvider> secp_provider_;
     std::shared_ptr<Interpreter> vm_interpreter_;
+    std::shared_ptr<SignatureVerifier> signature_verifier_;
+    std::shared_ptr<BlsAggregateVerifier> bls_aggregate_verifier_;
 
     /**
      * BlockHeader CID -> Parent tipset
@@ -122,6 +132,13 @@ namespace fc::blockchain::block_validator {
      */
     outcome::result<void> messageSign(const BlockHeader &header) const;
 
+    /**
+     * @brief Check block BLS messages aggregated signature
+     * @param header - block to check
+     * @return Check result
+     */
+    outcome::result<void> blsAggregate(const BlockHeader &header) const;
+
     /**
      * @brief Check parent state tree
      * @param header - block to check
@@ -144,6 +161,8 @@ namespace fc::blockchain::block_validator {
     kInvalidBlockSignature,
     kInvalidMinerPublicKey,
     kInvalidParentState,
+    kInvalidMessageSignature,
+    kInvalidBlsAggregate,
   };
 
 }  // namespace fc::blockchain::block_validator
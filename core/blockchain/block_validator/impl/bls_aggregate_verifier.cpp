@@ -0,0 +1,122 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/block_validator/impl/bls_aggregate_verifier.hpp"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+#include <boost/asio/post.hpp>
+
+#include "common/todo_error.hpp"
+#include "vm/message/message.hpp"
+#include "vm/runtime/env.hpp"
+
+namespace fc::blockchain::block_validator {
+  using Clock = std::chrono::steady_clock;
+  using primitives::address::BLSPublicKeyHash;
+  using primitives::block::MsgMeta;
+  using vm::message::UnsignedMessage;
+  using vm::state::StateTreeImpl;
+
+  BlsAggregateVerifier::BlsAggregateVerifier(
+      std::shared_ptr<BlsProvider> bls_provider, size_t threads)
+      : bls_provider_{std::move(bls_provider)},
+        pool_{std::max<size_t>(1, threads)} {}
+
+  BlsAggregateVerifier::~BlsAggregateVerifier() {
+    pool_.join();
+  }
+
+  outcome::result<BlsAggregateVerifier::Item> BlsAggregateVerifier::item(
+      const IpldPtr &ipld, const BlockHeader &block) {
+    Item item;
+    item.aggregate = block.bls_aggregate;
+    OUTCOME_TRY(meta, ipld->getCbor<MsgMeta>(block.messages));
+    StateTreeImpl state_tree{ipld, block.parent_state_root};
+    std::map<Address, crypto::bls::PublicKey> keys;
+    OUTCOME_TRY(meta.bls_messages.visit(
+        [&](auto, auto &cid) -> outcome::result<void> {
+          OUTCOME_TRY(message, ipld->getCbor<UnsignedMessage>(cid));
+          auto it{keys.find(message.from)};
+          if (it == keys.end()) {
+            OUTCOME_TRY(key, vm::runtime::resolveKey(state_tree, message.from));
+            auto hash{boost::get<BLSPublicKeyHash>(&key.data)};
+            if (!hash) {
+              return TodoError::kError;
+            }
+            it = keys.emplace(message.from, *hash).first;
+          }
+          item.cids.push_back(cid);
+          item.keys.push_back(it->second);
+          return outcome::success();
+        }));
+    return std::move(item);
+  }
+
+  BlsAggregateVerifier::Result BlsAggregateVerifier::verify(
+      const Item &item) const {
+    auto start{Clock::now()};
+    Result result;
+    if (item.aggregate) {
+      std::vector<Buffer> bytes;
+      std::vector<gsl::span<const uint8_t>> messages;
+      bytes.reserve(item.cids.size());
+      for (auto &cid : item.cids) {
+        if (auto cid_bytes{cid.toBytes()}) {
+          bytes.emplace_back(cid_bytes.value());
+          messages.emplace_back(bytes.back());
+        }
+      }
+      if (messages.size() == item.cids.size()) {
+        auto valid{bls_provider_->verifyAggregateSignature(
+            messages, *item.aggregate, item.keys)};
+        result.valid = valid && valid.value();
+      }
+    } else {
+      result.valid = item.cids.empty();
+    }
+    result.time = Clock::now() - start;
+    return result;
+  }
+
+  std::vector<BlsAggregateVerifier::Result> BlsAggregateVerifier::verify(
+      gsl::span<const Item> items) {
+    std::vector<Result> results(items.size());
+    if (items.size() <= 1) {
+      for (auto i{0u}; i < items.size(); ++i) {
+        results[i] = verify(items[i]);
+      }
+      return results;
+    }
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining = items.size();
+    for (auto i{0u}; i < items.size(); ++i) {
+      boost::asio::post(pool_, [&, i] {
+        results[i] = verify(items[i]);
+        std::lock_guard lock{mutex};
+        if (--remaining == 0) {
+          done.notify_one();
+        }
+      });
+    }
+    std::unique_lock lock{mutex};
+    done.wait(lock, [&] { return remaining == 0; });
+    return results;
+  }
+
+  outcome::result<std::vector<BlsAggregateVerifier::Result>>
+  BlsAggregateVerifier::verify(const IpldPtr &ipld,
+                               const std::vector<BlockHeader> &blocks) {
+    std::vector<Item> items;
+    for (auto &block : blocks) {
+      OUTCOME_TRY(item, BlsAggregateVerifier::item(ipld, block));
+      items.push_back(std::move(item));
+    }
+    return verify(items);
+  }
+}  // namespace fc::blockchain::block_validator
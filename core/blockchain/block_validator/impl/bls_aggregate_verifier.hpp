@@ -0,0 +1,76 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_BLOCK_VALIDATOR_IMPL_BLS_AGGREGATE_VERIFIER_HPP
+#define CPP_FILECOIN_CORE_BLOCKCHAIN_BLOCK_VALIDATOR_IMPL_BLS_AGGREGATE_VERIFIER_HPP
+
+#include <chrono>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include "crypto/bls/bls_provider.hpp"
+#include "primitives/block/block.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::blockchain::block_validator {
+  using crypto::bls::BlsProvider;
+  using primitives::block::BlockHeader;
+
+  /**
+   * Verifies BLS aggregate signatures of blocks, blocks of tipset are
+   * verified in parallel.
+   * Signed data are message cids stored in block message meta, so messages
+   * are not encoded again.
+   */
+  class BlsAggregateVerifier {
+   public:
+    /// Signed message cids and sender keys of block
+    struct Item {
+      std::vector<CID> cids;
+      std::vector<crypto::bls::PublicKey> keys;
+      boost::optional<crypto::bls::Signature> aggregate;
+    };
+
+    struct Result {
+      bool valid{};
+      std::chrono::nanoseconds time{};
+    };
+
+    /**
+     * @param bls_provider - used to verify aggregates
+     * @param threads - thread pool size
+     */
+    BlsAggregateVerifier(std::shared_ptr<BlsProvider> bls_provider,
+                         size_t threads);
+    ~BlsAggregateVerifier();
+
+    /**
+     * Collect bls message cids of block and sender keys, resolved in parent
+     * state of block
+     */
+    static outcome::result<Item> item(const IpldPtr &ipld,
+                                      const BlockHeader &block);
+
+    /// Verify one aggregate on caller thread
+    Result verify(const Item &item) const;
+
+    /// Verify aggregates in parallel, blocks until all are verified
+    std::vector<Result> verify(gsl::span<const Item> items);
+
+    /**
+     * Verify aggregates of tipset blocks in parallel
+     * @param blocks - tipset blocks, their parent state must be computed
+     * @return result of each block
+     */
+    outcome::result<std::vector<Result>> verify(
+        const IpldPtr &ipld, const std::vector<BlockHeader> &blocks);
+
+   private:
+    std::shared_ptr<BlsProvider> bls_provider_;
+    boost::asio::thread_pool pool_;
+  };
+}  // namespace fc::blockchain::block_validator
+
+#endif  // CPP_FILECOIN_CORE_BLOCKCHAIN_BLOCK_VALIDATOR_IMPL_BLS_AGGREGATE_VERIFIER_HPP
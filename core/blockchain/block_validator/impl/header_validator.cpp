@@ -0,0 +1,157 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/block_validator/impl/header_validator.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+#include <boost/asio/post.hpp>
+
+#include "blockchain/block_validator/impl/syntax_rules.hpp"
+
+namespace fc::blockchain::block_validator {
+  using primitives::block::BlockHeader;
+
+  HeaderValidator::HeaderValidator(std::shared_ptr<Beaconizer> beaconizer,
+                                   std::shared_ptr<DrandSchedule> schedule,
+                                   uint64_t block_delay,
+                                   size_t threads)
+      : beaconizer_{std::move(beaconizer)},
+        schedule_{std::move(schedule)},
+        block_delay_{block_delay},
+        pool_{std::max<size_t>(1, threads)} {}
+
+  HeaderValidator::~HeaderValidator() {
+    pool_.join();
+  }
+
+  outcome::result<void> HeaderValidator::validate(
+      const Tipset &ts,
+      const Tipset &parent,
+      const boost::optional<BeaconEntry> &prev_beacon) const {
+    if (ts.getParents() != parent.key) {
+      return HeaderError::kInvalidParents;
+    }
+    if (ts.height() <= parent.height()) {
+      return HeaderError::kInvalidHeight;
+    }
+    auto timestamp{parent.blks[0].timestamp
+                   + block_delay_ * (ts.height() - parent.height())};
+    for (auto &block : ts.blks) {
+      OUTCOME_TRY(SyntaxRules::parentsCount(block));
+      if (block.timestamp != timestamp) {
+        return HeaderError::kInvalidTimestamp;
+      }
+      if (block.parent_weight < parent.blks[0].parent_weight) {
+        return HeaderError::kInvalidParentWeight;
+      }
+      if (!block.ticket) {
+        return HeaderError::kNoTicket;
+      }
+      if (block.election_proof.win_count < 1) {
+        return HeaderError::kInvalidElectionProof;
+      }
+      if (!block.block_sig) {
+        return HeaderError::kNoBlockSignature;
+      }
+      if (!block.bls_aggregate) {
+        return HeaderError::kNoBlsAggregate;
+      }
+      if (prev_beacon) {
+        OUTCOME_TRY(beacons(block, *prev_beacon));
+      }
+    }
+    return outcome::success();
+  }
+
+  std::vector<outcome::result<void>> HeaderValidator::validate(
+      gsl::span<const TipsetCPtr> chain,
+      const boost::optional<BeaconEntry> &base_beacon) {
+    if (chain.size() < 2) {
+      return {};
+    }
+    auto n{static_cast<size_t>(chain.size()) - 1};
+    // latest beacon of parent depends on ancestors, so it is found serially
+    std::vector<boost::optional<BeaconEntry>> prev_beacons(n);
+    auto beacon{base_beacon};
+    for (auto i{n}; i != 0; --i) {
+      prev_beacons[i - 1] = beacon;
+      auto &entries{chain[i - 1]->blks[0].beacon_entries};
+      if (!entries.empty()) {
+        beacon = entries.back();
+      }
+    }
+    std::vector<outcome::result<void>> results(n, outcome::success());
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining{n};
+    for (auto i{0u}; i < n; ++i) {
+      boost::asio::post(pool_, [&, i] {
+        results[i] = validate(*chain[i], *chain[i + 1], prev_beacons[i]);
+        std::lock_guard lock{mutex};
+        if (--remaining == 0) {
+          done.notify_one();
+        }
+      });
+    }
+    std::unique_lock lock{mutex};
+    done.wait(lock, [&] { return remaining == 0; });
+    return results;
+  }
+
+  outcome::result<void> HeaderValidator::beacons(const BlockHeader &block,
+                                                 BeaconEntry prev) const {
+    auto &entries{block.beacon_entries};
+    if (schedule_) {
+      auto max_round{schedule_->maxRound(block.height)};
+      if (max_round == prev.round) {
+        if (!entries.empty()) {
+          return HeaderError::kInvalidBeacon;
+        }
+        return outcome::success();
+      }
+      if (entries.empty() || entries.back().round != max_round) {
+        return HeaderError::kInvalidBeacon;
+      }
+    }
+    for (auto &entry : entries) {
+      if (entry.round <= prev.round) {
+        return HeaderError::kInvalidBeacon;
+      }
+      if (beaconizer_) {
+        OUTCOME_TRY(beaconizer_->verifyEntry(entry, prev));
+      }
+      prev = entry;
+    }
+    return outcome::success();
+  }
+}  // namespace fc::blockchain::block_validator
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::block_validator, HeaderError, e) {
+  using fc::blockchain::block_validator::HeaderError;
+  switch (e) {
+    case HeaderError::kInvalidParents:
+      return "Header validation: parents don't match parent tipset";
+    case HeaderError::kInvalidHeight:
+      return "Header validation: height is not above parent";
+    case HeaderError::kInvalidTimestamp:
+      return "Header validation: invalid timestamp";
+    case HeaderError::kInvalidParentWeight:
+      return "Header validation: parent weight is below grandparent weight";
+    case HeaderError::kNoTicket:
+      return "Header validation: no ticket";
+    case HeaderError::kInvalidElectionProof:
+      return "Header validation: invalid election proof";
+    case HeaderError::kNoBlockSignature:
+      return "Header validation: no block signature";
+    case HeaderError::kNoBlsAggregate:
+      return "Header validation: no bls aggregate";
+    case HeaderError::kInvalidBeacon:
+      return "Header validation: invalid beacon entries";
+  }
+  return "Header validation: unknown error";
+}
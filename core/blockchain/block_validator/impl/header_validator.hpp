@@ -0,0 +1,85 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/asio/thread_pool.hpp>
+
+#include "drand/beaconizer.hpp"
+#include "primitives/tipset/tipset.hpp"
+
+namespace fc::blockchain::block_validator {
+  using drand::BeaconEntry;
+  using drand::Beaconizer;
+  using drand::DrandSchedule;
+  using primitives::tipset::Tipset;
+  using primitives::tipset::TipsetCPtr;
+
+  /**
+   * Checks tipset headers, which need only headers of tipset and its parent:
+   * chain links, heights, timestamps, parent weights, presence of tickets,
+   * election proofs and signatures, and beacon entries.
+   * Chain segment is checked in parallel before its messages are fetched and
+   * executed.
+   */
+  class HeaderValidator {
+   public:
+    /**
+     * @param beaconizer - verifies beacon entries, if set
+     * @param schedule - max beacon round of epoch, if set
+     * @param block_delay - seconds between epochs
+     * @param threads - thread pool size
+     */
+    HeaderValidator(std::shared_ptr<Beaconizer> beaconizer,
+                    std::shared_ptr<DrandSchedule> schedule,
+                    uint64_t block_delay,
+                    size_t threads);
+    ~HeaderValidator();
+
+    /**
+     * Check tipset against parent on caller thread
+     * @param prev_beacon - latest beacon of parent, beacons are not checked if
+     * not set
+     */
+    outcome::result<void> validate(
+        const Tipset &ts,
+        const Tipset &parent,
+        const boost::optional<BeaconEntry> &prev_beacon) const;
+
+    /**
+     * Check chain segment in parallel, blocks until all are checked
+     * @param chain - tipsets from descendant to ancestor, last tipset is
+     * known parent of segment and is not checked
+     * @param base_beacon - latest beacon of last tipset
+     * @return results of all tipsets except last
+     */
+    std::vector<outcome::result<void>> validate(
+        gsl::span<const TipsetCPtr> chain,
+        const boost::optional<BeaconEntry> &base_beacon);
+
+   private:
+    outcome::result<void> beacons(const primitives::block::BlockHeader &block,
+                                  BeaconEntry prev) const;
+
+    std::shared_ptr<Beaconizer> beaconizer_;
+    std::shared_ptr<DrandSchedule> schedule_;
+    uint64_t block_delay_;
+    boost::asio::thread_pool pool_;
+  };
+
+  enum class HeaderError {
+    kInvalidParents = 1,
+    kInvalidHeight,
+    kInvalidTimestamp,
+    kInvalidParentWeight,
+    kNoTicket,
+    kInvalidElectionProof,
+    kNoBlockSignature,
+    kNoBlsAggregate,
+    kInvalidBeacon,
+  };
+}  // namespace fc::blockchain::block_validator
+
+OUTCOME_HPP_DECLARE_ERROR(fc::blockchain::block_validator, HeaderError);
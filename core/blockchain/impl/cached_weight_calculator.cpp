@@ -0,0 +1,62 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/impl/cached_weight_calculator.hpp"
+
+#include "codec/cbor/cbor.hpp"
+
+namespace fc::blockchain::weight {
+  using common::Buffer;
+
+  namespace {
+    Buffer weightKey(const TipsetKey &key) {
+      return Buffer{}.put("weight:").put(key.hash());
+    }
+  }  // namespace
+
+  CachedWeightCalculator::CachedWeightCalculator(
+      std::shared_ptr<WeightCalculator> calculator,
+      std::shared_ptr<PersistentBufferMap> store,
+      size_t cache)
+      : calculator_{std::move(calculator)},
+        store_{std::move(store)},
+        cache_{cache} {}
+
+  outcome::result<BigInt> CachedWeightCalculator::calculateWeight(
+      const Tipset &tipset) {
+    OUTCOME_TRY(saved, getWeight(tipset.key));
+    if (saved) {
+      return std::move(*saved);
+    }
+    OUTCOME_TRY(weight, calculator_->calculateWeight(tipset));
+    OUTCOME_TRY(setWeight(tipset.key, weight));
+    return std::move(weight);
+  }
+
+  outcome::result<boost::optional<BigInt>> CachedWeightCalculator::getWeight(
+      const TipsetKey &key) {
+    std::lock_guard lock{mutex_};
+    if (auto weight{cache_.get(key)}) {
+      return std::move(*weight);
+    }
+    auto _key{weightKey(key)};
+    if (!store_->contains(_key)) {
+      return boost::none;
+    }
+    OUTCOME_TRY(raw, store_->get(_key));
+    OUTCOME_TRY(weight, codec::cbor::decode<BigInt>(raw));
+    cache_.put(key, weight);
+    return std::move(weight);
+  }
+
+  outcome::result<void> CachedWeightCalculator::setWeight(
+      const TipsetKey &key, const BigInt &weight) {
+    OUTCOME_TRY(raw, codec::cbor::encode(weight));
+    std::lock_guard lock{mutex_};
+    OUTCOME_TRY(store_->put(weightKey(key), raw));
+    cache_.put(key, weight);
+    return outcome::success();
+  }
+}  // namespace fc::blockchain::weight
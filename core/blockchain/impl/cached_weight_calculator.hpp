@@ -0,0 +1,50 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_CHAIN_IMPL_CACHED_WEIGHT_CALCULATOR_HPP
+#define CPP_FILECOIN_CORE_CHAIN_IMPL_CACHED_WEIGHT_CALCULATOR_HPP
+
+#include "blockchain/weight_calculator.hpp"
+
+#include <mutex>
+
+#include "common/lru_cache.hpp"
+#include "storage/buffer_map.hpp"
+
+namespace fc::blockchain::weight {
+  using primitives::tipset::TipsetKey;
+  using storage::PersistentBufferMap;
+
+  /**
+   * Persists weights calculated by other calculator, recent weights are
+   * cached. Weight of tipset never changes, so fork choice and api queries
+   * of known tipsets don't load power actor state again.
+   */
+  class CachedWeightCalculator : public WeightCalculator {
+   public:
+    /// Default number of cached weights
+    static constexpr size_t kDefaultCache{1 << 16};
+
+    CachedWeightCalculator(std::shared_ptr<WeightCalculator> calculator,
+                           std::shared_ptr<PersistentBufferMap> store,
+                           size_t cache = kDefaultCache);
+
+    outcome::result<BigInt> calculateWeight(const Tipset &tipset) override;
+
+    /// Returns saved weight of tipset, none if it was not calculated
+    outcome::result<boost::optional<BigInt>> getWeight(const TipsetKey &key);
+
+    /// Saves weight calculated elsewhere, e.g. during replay
+    outcome::result<void> setWeight(const TipsetKey &key, const BigInt &weight);
+
+   private:
+    std::shared_ptr<WeightCalculator> calculator_;
+    std::shared_ptr<PersistentBufferMap> store_;
+    std::mutex mutex_;
+    common::LruCache<TipsetKey, BigInt> cache_;
+  };
+}  // namespace fc::blockchain::weight
+
+#endif  // CPP_FILECOIN_CORE_CHAIN_IMPL_CACHED_WEIGHT_CALCULATOR_HPP
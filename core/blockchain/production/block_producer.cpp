@@ -5,7 +5,6 @@
 
 #include "blockchain/production/block_producer.hpp"
 
-#include "blockchain/impl/weight_calculator_impl.hpp"
 #include "crypto/bls/impl/bls_provider_impl.hpp"
 
 namespace fc::blockchain::production {
@@ -15,9 +14,11 @@ namespace fc::blockchain::production {
   using vm::message::SignedMessage;
   using vm::message::UnsignedMessage;
 
-  outcome::result<BlockWithMessages> generate(Interpreter &interpreter,
-                                              std::shared_ptr<Ipld> ipld,
-                                              BlockTemplate t) {
+  outcome::result<BlockWithMessages> generate(
+      Interpreter &interpreter,
+      WeightCalculator &weight_calculator,
+      std::shared_ptr<Ipld> ipld,
+      BlockTemplate t) {
     OUTCOME_TRY(parent_tipset,
                 primitives::tipset::Tipset::load(*ipld, t.parents));
     OUTCOME_TRY(vm_result, interpreter.interpret(ipld, parent_tipset));
@@ -48,9 +49,8 @@ namespace fc::blockchain::production {
     b.header.beacon_entries = std::move(t.beacon_entries);
     b.header.win_post_proof = std::move(t.win_post_proof);
     b.header.parents = std::move(t.parents);
-    OUTCOME_TRYA(
-        b.header.parent_weight,
-        weight::WeightCalculatorImpl{ipld}.calculateWeight(*parent_tipset));
+    OUTCOME_TRYA(b.header.parent_weight,
+                 weight_calculator.calculateWeight(*parent_tipset));
     b.header.height = t.height;
     b.header.parent_state_root = std::move(vm_result.state_root);
     b.header.parent_message_receipts = std::move(vm_result.message_receipts);
@@ -3,16 +3,20 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include "blockchain/weight_calculator.hpp"
 #include "vm/interpreter/interpreter.hpp"
 
 namespace fc::blockchain::production {
   using primitives::block::BlockTemplate;
   using primitives::block::BlockWithMessages;
   using vm::interpreter::Interpreter;
+  using weight::WeightCalculator;
 
   constexpr size_t kBlockMaxMessagesCount = 1000;
 
-  outcome::result<BlockWithMessages> generate(Interpreter &interpreter,
-                                              std::shared_ptr<Ipld> ipld,
-                                              BlockTemplate t);
+  outcome::result<BlockWithMessages> generate(
+      Interpreter &interpreter,
+      WeightCalculator &weight_calculator,
+      std::shared_ptr<Ipld> ipld,
+      BlockTemplate t);
 }  // namespace fc::blockchain::production
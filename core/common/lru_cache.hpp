@@ -0,0 +1,106 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
+namespace fc::common {
+  /**
+   * Bounded cache evicting least recently used entries.
+   * Capacity is total weight of values, each value weighs 1 by default.
+   * Not thread safe.
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>>
+  class LruCache {
+   public:
+    using Weigh = std::function<size_t(const Value &)>;
+
+    explicit LruCache(size_t capacity, Weigh weigh = {})
+        : capacity_{capacity}, weigh_{std::move(weigh)} {}
+
+    /// Returns value and marks it as recently used
+    boost::optional<Value> get(const Key &key) {
+      auto it{map_.find(key)};
+      if (it == map_.end()) {
+        ++misses_;
+        return boost::none;
+      }
+      ++hits_;
+      list_.splice(list_.begin(), list_, it->second);
+      return it->second->value;
+    }
+
+    bool contains(const Key &key) const {
+      return map_.find(key) != map_.end();
+    }
+
+    /// Inserts or replaces value, evicts old values over capacity
+    void put(const Key &key, Value value) {
+      erase(key);
+      auto weight{weigh_ ? weigh_(value) : 1};
+      list_.push_front({key, std::move(value), weight});
+      map_.emplace(key, list_.begin());
+      weight_ += weight;
+      while (weight_ > capacity_ && list_.size() > 1) {
+        erase(list_.back().key);
+      }
+    }
+
+    void erase(const Key &key) {
+      auto it{map_.find(key)};
+      if (it != map_.end()) {
+        weight_ -= it->second->weight;
+        list_.erase(it->second);
+        map_.erase(it);
+      }
+    }
+
+    void clear() {
+      map_.clear();
+      list_.clear();
+      weight_ = 0;
+    }
+
+    size_t size() const {
+      return map_.size();
+    }
+
+    /// Total weight of values
+    size_t weight() const {
+      return weight_;
+    }
+
+    size_t capacity() const {
+      return capacity_;
+    }
+
+    size_t hits() const {
+      return hits_;
+    }
+
+    size_t misses() const {
+      return misses_;
+    }
+
+   private:
+    struct Entry {
+      Key key;
+      Value value;
+      size_t weight;
+    };
+
+    size_t capacity_;
+    Weigh weigh_;
+    std::list<Entry> list_;
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> map_;
+    size_t weight_{};
+    size_t hits_{}, misses_{};
+  };
+}  // namespace fc::common
@@ -52,6 +52,18 @@ namespace fc::crypto::bls {
         const Signature &signature,
         const PublicKey &key) const = 0;
 
+    /**
+     * @brief Verify aggregated BLS signature
+     * @param messages - signed data, one for each key
+     * @param signature - aggregated BLS signature
+     * @param keys - BLS public keys of signers
+     * @return signature status or error code
+     */
+    virtual outcome::result<bool> verifyAggregateSignature(
+        gsl::span<const gsl::span<const uint8_t>> messages,
+        const Signature &signature,
+        gsl::span<const PublicKey> keys) const = 0;
+
     /**
      * @brief Aggregate BLS signatures
      * @param signatures - signatures to aggregate
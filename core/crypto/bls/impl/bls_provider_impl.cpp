@@ -58,6 +58,32 @@ namespace fc::crypto::bls {
            > 0;
   }
 
+  outcome::result<bool> BlsProviderImpl::verifyAggregateSignature(
+      gsl::span<const gsl::span<const uint8_t>> messages,
+      const Signature &signature,
+      gsl::span<const PublicKey> keys) const {
+    if (messages.size() != keys.size()) {
+      return false;
+    }
+    if (messages.empty()) {
+      OUTCOME_TRY(empty, aggregateSignatures({}));
+      return signature == empty;
+    }
+    std::vector<uint8_t> digests;
+    digests.reserve(messages.size() * std::tuple_size_v<Digest>);
+    for (auto &message : messages) {
+      OUTCOME_TRY(digest, generateHash(message));
+      digests.insert(digests.end(), digest.begin(), digest.end());
+    }
+    auto keys_bytes{common::span::cast<const uint8_t>(keys)};
+    return fil_verify(signature.data(),
+                      digests.data(),
+                      digests.size(),
+                      keys_bytes.data(),
+                      keys_bytes.size())
+           > 0;
+  }
+
   outcome::result<Digest> BlsProviderImpl::generateHash(
       gsl::span<const uint8_t> message) {
     auto response{ffi::wrap(fil_hash(message.data(), message.size()),
@@ -5,8 +5,10 @@
 
 #include "hasher.hpp"
 
-#include <libp2p/crypto/sha/sha256.hpp>
+#include <stdexcept>
+
 #include "crypto/blake2/blake2b160.hpp"
+#include "crypto/hasher/multi_buffer.hpp"
 
 namespace fc::crypto {
   std::map<Hasher::HashType, Hasher::HashMethod> Hasher::methods_{
@@ -20,7 +22,9 @@ namespace fc::crypto {
   }
 
   Hasher::Multihash Hasher::sha2_256(gsl::span<const uint8_t> buffer) {
-    auto digest = libp2p::crypto::sha256(buffer);
+    common::Hash256 digest;
+    multi_buffer::sha256(gsl::make_span(&buffer, 1),
+                         gsl::make_span(&digest, 1));
     auto multi_hash = Multihash::create(HashType::sha256, digest);
     BOOST_ASSERT_MSG(multi_hash.has_value(),
                      "fc::crypto::Hasher - failed to create sha2-256 hash");
@@ -34,4 +38,25 @@ namespace fc::crypto {
                      "fc::crypto::Hasher - failed to create blake2b_256 hash");
     return multi_hash.value();
   }
+
+  std::vector<Hasher::Multihash> Hasher::calculateBatch(
+      HashType hash_type, gsl::span<const Input> inputs) {
+    std::vector<common::Hash256> digests(inputs.size());
+    if (hash_type == HashType::sha256) {
+      multi_buffer::sha256(inputs, digests);
+    } else if (hash_type == HashType::blake2b_256) {
+      multi_buffer::blake2b_256(inputs, digests);
+    } else {
+      throw std::out_of_range{"fc::crypto::Hasher - unsupported hash type"};
+    }
+    std::vector<Multihash> hashes;
+    hashes.reserve(digests.size());
+    for (auto &digest : digests) {
+      auto multi_hash = Multihash::create(hash_type, digest);
+      BOOST_ASSERT_MSG(multi_hash.has_value(),
+                       "fc::crypto::Hasher - failed to create hash");
+      hashes.push_back(std::move(multi_hash.value()));
+    }
+    return hashes;
+  }
 }  // namespace fc::crypto
@@ -7,6 +7,7 @@
 #define FILECOIN_CORE_CRYPTO_HASHER_HPP
 
 #include <map>
+#include <vector>
 
 #include <libp2p/multi/multihash.hpp>
 
@@ -21,6 +22,7 @@ namespace fc::crypto {
     using HashType = libp2p::multi::HashType;
     using Multihash = libp2p::multi::Multihash;
     using HashMethod = Multihash (*)(gsl::span<const uint8_t>);
+    using Input = gsl::span<const uint8_t>;
 
    private:
     static std::map<HashType, HashMethod> methods_;
@@ -42,6 +44,16 @@ namespace fc::crypto {
      * @return Blake2b-256 hash
      */
     static Multihash blake2b_256(gsl::span<const uint8_t> buffer);
+
+    /**
+     * @brief Calculate hashes of independent buffers with multi-buffer
+     * SIMD kernels when supported by CPU
+     * @param hash_type - sha2-256 or blake2b-256
+     * @param inputs - source data
+     * @return hash of each input
+     */
+    static std::vector<Multihash> calculateBatch(HashType hash_type,
+                                                 gsl::span<const Input> inputs);
   };
 }  // namespace fc::crypto
 
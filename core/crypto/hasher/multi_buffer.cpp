@@ -0,0 +1,323 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "crypto/hasher/multi_buffer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#include <libp2p/crypto/sha/sha256.hpp>
+#include "crypto/blake2/blake2b160.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FC_MULTI_BUFFER_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace fc::crypto::multi_buffer {
+  constexpr size_t kSha256Block{64};
+  constexpr size_t kBlake2bBlock{128};
+  constexpr size_t kBlake2bLanes{4};
+
+  void sha256Scalar(Input input, Hash256 &output) {
+    auto digest{libp2p::crypto::sha256(input)};
+    std::copy(digest.begin(), digest.end(), output.begin());
+  }
+
+  void blake2bScalar(Input input, Hash256 &output) {
+    output = blake2b::blake2b_256(input);
+  }
+
+#ifdef FC_MULTI_BUFFER_X86
+  Cpu detect() {
+    Cpu cpu;
+    unsigned a{}, b{}, c{}, d{};
+    if (!__get_cpuid(1, &a, &b, &c, &d)) {
+      return cpu;
+    }
+    auto ssse3{(c & bit_SSSE3) != 0}, sse41{(c & bit_SSE4_1) != 0};
+    auto osxsave{(c & bit_OSXSAVE) != 0}, avx{(c & bit_AVX) != 0};
+    if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+      return cpu;
+    }
+    cpu.sha = ssse3 && sse41 && (b & bit_SHA) != 0;
+    if (osxsave && avx && (b & bit_AVX2) != 0) {
+      // os saves ymm registers
+      uint32_t xcr0_lo, xcr0_hi;
+      __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+      cpu.avx2 = (xcr0_lo & 6) == 6;
+    }
+    return cpu;
+  }
+
+  alignas(16) const uint32_t kSha256K[64]{
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+      0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+      0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+      0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+      0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+      0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+      0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+  };
+
+  /// SHA-NI compression of 64 byte blocks
+  __attribute__((target("sha,sse4.1,ssse3"))) void sha256Blocks(
+      uint32_t state[8], const uint8_t *data, size_t blocks) {
+    const auto mask{
+        _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL)};
+    auto tmp{_mm_loadu_si128((const __m128i *)&state[0])};
+    auto state1{_mm_loadu_si128((const __m128i *)&state[4])};
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);
+    state1 = _mm_shuffle_epi32(state1, 0x1B);
+    auto state0{_mm_alignr_epi8(tmp, state1, 8)};
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+    for (; blocks != 0; --blocks, data += kSha256Block) {
+      auto abef{state0}, cdgh{state1};
+      __m128i w[4];
+      for (auto i{0}; i < 16; ++i) {
+        if (i < 4) {
+          w[i] = _mm_shuffle_epi8(
+              _mm_loadu_si128((const __m128i *)(data + 16 * i)), mask);
+        } else {
+          auto &w4{w[i % 4]};
+          auto &w3{w[(i + 1) % 4]}, &w2{w[(i + 2) % 4]}, &w1{w[(i + 3) % 4]};
+          w4 = _mm_sha256msg2_epu32(
+              _mm_add_epi32(_mm_sha256msg1_epu32(w4, w3),
+                            _mm_alignr_epi8(w1, w2, 4)),
+              w1);
+        }
+        auto msg{_mm_add_epi32(
+            w[i % 4], _mm_load_si128((const __m128i *)&kSha256K[4 * i]))};
+        state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+        state0 = _mm_sha256rnds2_epu32(
+            state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+      }
+      state0 = _mm_add_epi32(state0, abef);
+      state1 = _mm_add_epi32(state1, cdgh);
+    }
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i *)&state[0], state0);
+    _mm_storeu_si128((__m128i *)&state[4], state1);
+  }
+
+  void sha256Ni(Input input, Hash256 &output) {
+    uint32_t state[8]{0x6a09e667,
+                      0xbb67ae85,
+                      0x3c6ef372,
+                      0xa54ff53a,
+                      0x510e527f,
+                      0x9b05688c,
+                      0x1f83d9ab,
+                      0x5be0cd19};
+    size_t size = input.size();
+    auto full{size / kSha256Block};
+    sha256Blocks(state, input.data(), full);
+    uint8_t tail[2 * kSha256Block]{};
+    auto rest{size % kSha256Block};
+    std::copy_n(input.data() + full * kSha256Block, rest, tail);
+    tail[rest] = 0x80;
+    auto tail_blocks{rest + 9 > kSha256Block ? 2u : 1u};
+    uint64_t bits{size * 8};
+    for (auto i{0}; i < 8; ++i) {
+      tail[tail_blocks * kSha256Block - 1 - i] = bits >> (8 * i);
+    }
+    sha256Blocks(state, tail, tail_blocks);
+    for (auto i{0}; i < 32; ++i) {
+      output[i] = state[i / 4] >> (24 - 8 * (i % 4));
+    }
+  }
+
+  const uint64_t kBlake2bIv[8]{
+      0x6A09E667F3BCC908,
+      0xBB67AE8584CAA73B,
+      0x3C6EF372FE94F82B,
+      0xA54FF53A5F1D36F1,
+      0x510E527FADE682D1,
+      0x9B05688C2B3E6C1F,
+      0x1F83D9ABFB41BD6B,
+      0x5BE0CD19137E2179,
+  };
+  const uint8_t kBlake2bSigma[12][16]{
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+      {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+      {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+      {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+      {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+      {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+      {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+      {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+      {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+      {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+      {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+  };
+
+  __attribute__((target("avx2"))) inline __m256i rotr(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi64(x, n),
+                           _mm256_slli_epi64(x, 64 - n));
+  }
+
+  __attribute__((target("avx2"))) inline void blake2bG(
+      __m256i *v, int a, int b, int c, int d, __m256i x, __m256i y) {
+    v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), x);
+    v[d] = _mm256_shuffle_epi32(_mm256_xor_si256(v[d], v[a]), 0xB1);
+    v[c] = _mm256_add_epi64(v[c], v[d]);
+    v[b] = rotr(_mm256_xor_si256(v[b], v[c]), 24);
+    v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), y);
+    v[d] = rotr(_mm256_xor_si256(v[d], v[a]), 16);
+    v[c] = _mm256_add_epi64(v[c], v[d]);
+    v[b] = rotr(_mm256_xor_si256(v[b], v[c]), 63);
+  }
+
+  /**
+   * Blake2b-256 of 4 inputs, each 64 bit lane hashes own input.
+   * Lanes with fewer blocks keep their state while others continue.
+   */
+  __attribute__((target("avx2"))) void blake2bX4(const Input *inputs,
+                                                 Hash256 *outputs,
+                                                 size_t lanes) {
+    size_t blocks[kBlake2bLanes]{};
+    size_t max_blocks{0};
+    for (auto j{0u}; j < lanes; ++j) {
+      blocks[j] = std::max<size_t>(
+          1, (inputs[j].size() + kBlake2bBlock - 1) / kBlake2bBlock);
+      max_blocks = std::max(max_blocks, blocks[j]);
+    }
+    __m256i h[8];
+    for (auto i{0}; i < 8; ++i) {
+      h[i] = _mm256_set1_epi64x(kBlake2bIv[i]);
+    }
+    h[0] = _mm256_xor_si256(h[0], _mm256_set1_epi64x(0x01010000 ^ 32));
+    alignas(32) uint64_t m_words[16][kBlake2bLanes];
+    alignas(32) uint64_t counter[kBlake2bLanes], last[kBlake2bLanes],
+        active[kBlake2bLanes];
+    for (size_t block{0}; block < max_blocks; ++block) {
+      for (auto j{0u}; j < kBlake2bLanes; ++j) {
+        uint8_t bytes[kBlake2bBlock]{};
+        active[j] = j < lanes && block < blocks[j] ? ~0ull : 0;
+        last[j] = active[j] && block + 1 == blocks[j] ? ~0ull : 0;
+        counter[j] = 0;
+        if (active[j]) {
+          auto offset{block * kBlake2bBlock};
+          auto size{std::min<size_t>(kBlake2bBlock,
+                                     inputs[j].size() - offset)};
+          std::copy_n(inputs[j].data() + offset, size, bytes);
+          counter[j] = offset + size;
+        }
+        for (auto i{0}; i < 16; ++i) {
+          uint64_t word{0};
+          for (auto k{7}; k >= 0; --k) {
+            word = (word << 8) | bytes[8 * i + k];
+          }
+          m_words[i][j] = word;
+        }
+      }
+      __m256i m[16], v[16];
+      for (auto i{0}; i < 16; ++i) {
+        m[i] = _mm256_load_si256((const __m256i *)m_words[i]);
+      }
+      for (auto i{0}; i < 8; ++i) {
+        v[i] = h[i];
+        v[i + 8] = _mm256_set1_epi64x(kBlake2bIv[i]);
+      }
+      v[12] = _mm256_xor_si256(v[12],
+                               _mm256_load_si256((const __m256i *)counter));
+      v[14] =
+          _mm256_xor_si256(v[14], _mm256_load_si256((const __m256i *)last));
+      for (auto &s : kBlake2bSigma) {
+        blake2bG(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        blake2bG(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        blake2bG(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        blake2bG(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        blake2bG(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        blake2bG(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        blake2bG(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        blake2bG(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+      }
+      auto mask{_mm256_load_si256((const __m256i *)active)};
+      for (auto i{0}; i < 8; ++i) {
+        auto next{_mm256_xor_si256(h[i], _mm256_xor_si256(v[i], v[i + 8]))};
+        h[i] = _mm256_blendv_epi8(h[i], next, mask);
+      }
+    }
+    alignas(32) uint64_t words[4][kBlake2bLanes];
+    for (auto i{0}; i < 4; ++i) {
+      _mm256_store_si256((__m256i *)words[i], h[i]);
+    }
+    for (auto j{0u}; j < lanes; ++j) {
+      for (auto i{0}; i < 32; ++i) {
+        outputs[j][i] = words[i / 8][j] >> (8 * (i % 8));
+      }
+    }
+  }
+#else
+  Cpu detect() {
+    return {};
+  }
+#endif
+
+  const Cpu &cpu() {
+    static const Cpu cpu{detect()};
+    return cpu;
+  }
+
+  void sha256(gsl::span<const Input> inputs,
+              gsl::span<Hash256> outputs,
+              bool simd) {
+    assert(inputs.size() == outputs.size());
+#ifdef FC_MULTI_BUFFER_X86
+    if (simd && cpu().sha) {
+      for (auto i{0u}; i < inputs.size(); ++i) {
+        sha256Ni(inputs[i], outputs[i]);
+      }
+      return;
+    }
+#endif
+    for (auto i{0u}; i < inputs.size(); ++i) {
+      sha256Scalar(inputs[i], outputs[i]);
+    }
+  }
+
+  void blake2b_256(gsl::span<const Input> inputs,
+                   gsl::span<Hash256> outputs,
+                   bool simd) {
+    assert(inputs.size() == outputs.size());
+#ifdef FC_MULTI_BUFFER_X86
+    if (simd && cpu().avx2 && inputs.size() > 1) {
+      // lanes of similar length waste less work
+      std::vector<size_t> order(inputs.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](auto l, auto r) {
+        return inputs[l].size() < inputs[r].size();
+      });
+      Input lane_inputs[kBlake2bLanes];
+      Hash256 lane_outputs[kBlake2bLanes];
+      for (size_t i{0}; i < order.size(); i += kBlake2bLanes) {
+        auto lanes{std::min(kBlake2bLanes, order.size() - i)};
+        for (auto j{0u}; j < lanes; ++j) {
+          lane_inputs[j] = inputs[order[i + j]];
+        }
+        blake2bX4(lane_inputs, lane_outputs, lanes);
+        for (auto j{0u}; j < lanes; ++j) {
+          outputs[order[i + j]] = lane_outputs[j];
+        }
+      }
+      return;
+    }
+#endif
+    for (auto i{0u}; i < inputs.size(); ++i) {
+      blake2bScalar(inputs[i], outputs[i]);
+    }
+  }
+}  // namespace fc::crypto::multi_buffer
@@ -0,0 +1,47 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_CRYPTO_HASHER_MULTI_BUFFER_HPP
+#define CPP_FILECOIN_CORE_CRYPTO_HASHER_MULTI_BUFFER_HPP
+
+#include "common/blob.hpp"
+
+/**
+ * Hashing of many independent buffers at once.
+ * Kernels are selected at runtime by CPU features:
+ *   sha256 - SHA-NI, scalar fallback
+ *   blake2b-256 - AVX2 4 lanes, scalar fallback
+ */
+namespace fc::crypto::multi_buffer {
+  using common::Hash256;
+  using Input = gsl::span<const uint8_t>;
+
+  /// CPU features used by kernels
+  struct Cpu {
+    bool sha{};
+    bool avx2{};
+  };
+
+  /// Detected once
+  const Cpu &cpu();
+
+  /**
+   * Calculate SHA2-256 of each input
+   * @param simd - use SIMD kernel if supported by CPU
+   */
+  void sha256(gsl::span<const Input> inputs,
+              gsl::span<Hash256> outputs,
+              bool simd = true);
+
+  /**
+   * Calculate Blake2b-256 of each input
+   * @param simd - use SIMD kernel if supported by CPU
+   */
+  void blake2b_256(gsl::span<const Input> inputs,
+                   gsl::span<Hash256> outputs,
+                   bool simd = true);
+}  // namespace fc::crypto::multi_buffer
+
+#endif  // CPP_FILECOIN_CORE_CRYPTO_HASHER_MULTI_BUFFER_HPP
@@ -8,6 +8,8 @@
 #include "common/libp2p/cbor_stream.hpp"
 #include "node/blocksync.hpp"
 #include "primitives/tipset/tipset.hpp"
+#include "vm/message/signature_verifier.hpp"
+#include "vm/runtime/env.hpp"
 
 #define MOVE(x)  \
   x {            \
@@ -20,58 +22,17 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::blocksync, Error, e) {
 
 namespace fc::blocksync {
   using common::libp2p::CborStream;
-  using primitives::block::BlockHeader;
   using primitives::block::MsgMeta;
-  using primitives::block::SignedMessage;
-  using primitives::block::UnsignedMessage;
+  using primitives::tipset::TipsetKey;
 
-  static constexpr auto kProtocolId{"/fil/sync/blk/0.0.1"};
-  constexpr size_t kBlockSyncMaxRequestLength{800};
-
-  struct Request {
-    enum Options {
-      BLOCKS = 1,
-      MESSAGES = 2,
-      BLOCKS_AND_MESSAGES = BLOCKS | MESSAGES,
-    };
-
-    std::vector<CID> blocks;
-    size_t depth{1};
-    Options options{BLOCKS_AND_MESSAGES};
-  };
-  CBOR_TUPLE(Request, blocks, depth, options)
-
-  struct Response {
-    using Indices = std::vector<std::vector<size_t>>;
-
-    struct Messages {
-      std::vector<UnsignedMessage> bls_messages;
-      Indices bls_indices;
-      std::vector<SignedMessage> secp_messages;
-      Indices secp_indices;
-    };
-
-    struct Tipset {
-      std::vector<BlockHeader> blocks;
-      boost::optional<Messages> messages;
-    };
-
-    std::vector<Tipset> chain;
-    Error status;
-    std::string message;
-  };
-  CBOR_TUPLE(Response, status, message, chain)
-  CBOR_TUPLE(Response::Tipset, blocks, messages)
-  CBOR_TUPLE(Response::Messages,
-             bls_messages,
-             bls_indices,
-             secp_messages,
-             secp_indices)
-
-  outcome::result<std::shared_ptr<const Tipset>> unpack(
-      const IpldPtr &ipld, Response::Tipset packed) {
+  /// Stores messages of blocks, checks them against block headers
+  outcome::result<void> unpackMessages(
+      const IpldPtr &ipld,
+      const std::shared_ptr<SignatureVerifier> &verifier,
+      const std::vector<BlockHeader> &blocks,
+      const Response::Messages &msgs) {
     auto safe{[&](auto &messages, auto &indices) {
-      if (indices.size() != packed.blocks.size()) {
+      if (indices.size() != blocks.size()) {
         return false;
       }
       for (auto &indices2 : indices) {
@@ -83,40 +44,28 @@ namespace fc::blocksync {
       }
       return true;
     }};
-    auto &_msgs{packed.messages};
-    if (_msgs) {
-      if (!safe(_msgs->bls_messages, _msgs->bls_indices)
-          || !safe(_msgs->secp_messages, _msgs->secp_indices)) {
-        return Error::kInconsistent;
-      }
-    }
-    std::vector<BlockHeader> blocks;
-    for (auto &block : packed.blocks) {
-      OUTCOME_TRY(ipld->setCbor(block));
-      blocks.push_back(std::move(block));
+    if (!safe(msgs.bls_messages, msgs.bls_indices)
+        || !safe(msgs.secp_messages, msgs.secp_indices)) {
+      return Error::kInconsistent;
     }
     std::vector<CID> bls_cids, secp_cids;
-    if (_msgs) {
-      for (auto &message : _msgs->bls_messages) {
-        OUTCOME_TRY(cid, ipld->setCbor(message));
-        bls_cids.push_back(std::move(cid));
-      }
-      for (auto &message : _msgs->secp_messages) {
-        OUTCOME_TRY(cid, ipld->setCbor(message));
-        secp_cids.push_back(std::move(cid));
-      }
+    for (auto &message : msgs.bls_messages) {
+      OUTCOME_TRY(cid, ipld->setCbor(message));
+      bls_cids.push_back(std::move(cid));
+    }
+    for (auto &message : msgs.secp_messages) {
+      OUTCOME_TRY(cid, ipld->setCbor(message));
+      secp_cids.push_back(std::move(cid));
     }
     auto i{0};
     for (auto &block : blocks) {
       MsgMeta messages;
       ipld->load(messages);
-      if (_msgs) {
-        for (auto &j : _msgs->bls_indices[i]) {
-          OUTCOME_TRY(messages.bls_messages.append(bls_cids[j]));
-        }
-        for (auto &j : _msgs->secp_indices[i]) {
-          OUTCOME_TRY(messages.secp_messages.append(secp_cids[j]));
-        }
+      for (auto &j : msgs.bls_indices[i]) {
+        OUTCOME_TRY(messages.bls_messages.append(bls_cids[j]));
+      }
+      for (auto &j : msgs.secp_indices[i]) {
+        OUTCOME_TRY(messages.secp_messages.append(secp_cids[j]));
       }
       OUTCOME_TRY(cid, ipld->setCbor(messages));
       if (cid != block.messages) {
@@ -124,128 +73,188 @@ namespace fc::blocksync {
       }
       ++i;
     }
-    return Tipset::create(blocks);
+    // messages match blocks, so bad signature is fault of block, not peer
+    if (verifier && !blocks.empty()) {
+      // senders are resolved in parent state, if it is known, others are
+      // verified by TsSync::walkUp after parent state is computed
+      auto resolve{
+          vm::runtime::keyResolver(ipld, blocks[0].parent_state_root)};
+      std::vector<SignatureVerifier::Item> items;
+      for (auto &message : msgs.secp_messages) {
+        OUTCOME_TRY(item, SignatureVerifier::item(message, resolve));
+        if (item) {
+          items.push_back(std::move(*item));
+        }
+      }
+      auto valid{verifier->verify(items)};
+      if (std::find(valid.begin(), valid.end(), false) != valid.end()) {
+        return Error::kBadSignature;
+      }
+    }
+    return outcome::success();
   }
 
-  void fetch(std::shared_ptr<Host> host,
-             const PeerInfo &peer,
-             IpldPtr ipld,
-             std::vector<CID> blocks,
-             Cb cb) {
+  outcome::result<TipsetCPtr> unpackHeaders(const IpldPtr &ipld,
+                                            std::vector<BlockHeader> blocks) {
+    for (auto &block : blocks) {
+      OUTCOME_TRY(ipld->setCbor(block));
+    }
+    return Tipset::create(std::move(blocks));
+  }
+
+  outcome::result<TipsetCPtr> unpack(
+      const IpldPtr &ipld,
+      const std::shared_ptr<SignatureVerifier> &verifier,
+      Response::Tipset packed) {
+    if (!packed.messages) {
+      return Error::kInconsistent;
+    }
+    OUTCOME_TRY(
+        unpackMessages(ipld, verifier, packed.blocks, *packed.messages));
+    return unpackHeaders(ipld, std::move(packed.blocks));
+  }
+
+  /// Sends request to peer, calls cb with response of kOk or kPartial status
+  void sendRequest(std::shared_ptr<Host> host,
+                   const PeerInfo &peer,
+                   Request request,
+                   std::function<void(outcome::result<Response>)> cb) {
     host->newStream(
-        peer, kProtocolId, [MOVE(ipld), MOVE(blocks), MOVE(cb)](auto _stream) {
+        peer,
+        kProtocolId,
+        [MOVE(request), MOVE(cb)](auto _stream) {
           if (!_stream) {
             return cb(_stream.error());
           }
           auto stream{std::make_shared<CborStream>(_stream.value())};
-          stream->write(
-              Request{std::move(blocks)},
-              [stream, MOVE(ipld), MOVE(cb)](auto _n) {
-                if (!_n) {
+          stream->write(request, [stream, MOVE(cb)](auto _n) {
+            if (!_n) {
+              stream->close();
+              return cb(_n.error());
+            }
+            stream->template read<Response>(
+                [stream, MOVE(cb)](auto _response) {
                   stream->close();
-                  return cb(_n.error());
-                }
-                stream->template read<Response>(
-                    [stream, MOVE(ipld), MOVE(cb)](auto _response) {
-                      stream->close();
-                      if (!_response) {
-                        return cb(_response.error());
-                      }
-                      auto &response{_response.value()};
-                      if (response.status != Error::kOk) {
-                        return cb(response.status);
-                      }
-                      if (response.chain.empty()) {
-                        return cb(Error::kPartial);
-                      }
-                      cb(unpack(ipld, std::move(response.chain.front())));
-                    });
-              });
+                  if (!_response) {
+                    return cb(_response.error());
+                  }
+                  auto &response{_response.value()};
+                  if (response.status != Error::kOk
+                      && response.status != Error::kPartial) {
+                    return cb(response.status);
+                  }
+                  if (response.chain.empty()) {
+                    return cb(Error::kPartial);
+                  }
+                  cb(std::move(response));
+                });
+          });
         });
   }
 
-  template <typename T>
-  struct MessageVisitor {
-    outcome::result<void> operator()(size_t, const CID &cid) {
-      auto index{visited.find(cid)};
-      if (index == visited.end()) {
-        index = visited.emplace(cid, messages.size()).first;
-        OUTCOME_TRY(message, ipld->getCbor<T>(cid));
-        messages.push_back(std::move(message));
-      }
-      indices.rbegin()->push_back(index->second);
-      return outcome::success();
-    }
-
-    IpldPtr &ipld;
-    std::vector<T> &messages;
-    Response::Indices &indices;
-    std::map<CID, size_t> visited{};
-  };
+  void fetch(std::shared_ptr<Host> host,
+             const PeerInfo &peer,
+             IpldPtr ipld,
+             std::shared_ptr<SignatureVerifier> verifier,
+             std::vector<CID> blocks,
+             Cb cb) {
+    sendRequest(std::move(host),
+                peer,
+                {std::move(blocks)},
+                [MOVE(ipld), MOVE(verifier), MOVE(cb)](auto _response) {
+                  if (!_response) {
+                    return cb(_response.error());
+                  }
+                  cb(unpack(ipld,
+                            verifier,
+                            std::move(_response.value().chain.front())));
+                });
+  }
 
-  outcome::result<std::vector<Response::Tipset>> getChain(
-      IpldPtr ipld, const Request &request) {
-    OUTCOME_TRY(ts, Tipset::load(*ipld, request.blocks));
-    std::vector<Response::Tipset> chain;
-    while (true) {
-      Response::Tipset packed;
-      if (request.options & Request::MESSAGES) {
-        Response::Messages msgs;
-        MessageVisitor<UnsignedMessage> bls_visitor{
-            ipld, msgs.bls_messages, msgs.bls_indices};
-        MessageVisitor<SignedMessage> secp_visitor{
-            ipld, msgs.secp_messages, msgs.secp_indices};
-        for (auto &block : ts->blks) {
-          OUTCOME_TRY(meta, ipld->getCbor<MsgMeta>(block.messages));
-          msgs.bls_indices.emplace_back();
-          OUTCOME_TRY(meta.bls_messages.visit(bls_visitor));
-          msgs.secp_indices.emplace_back();
-          OUTCOME_TRY(meta.secp_messages.visit(secp_visitor));
-        }
-        packed.messages = std::move(msgs);
-      }
-      if (request.options & Request::BLOCKS) {
-        packed.blocks = ts->blks;
-      }
-      chain.push_back(std::move(packed));
-      if (chain.size() >= request.depth || ts->height() == 0) {
-        break;
-      }
-      OUTCOME_TRYA(ts, ts->loadParent(*ipld));
-    }
-    return chain;
+  void fetchHeaders(std::shared_ptr<Host> host,
+                    const PeerInfo &peer,
+                    IpldPtr ipld,
+                    std::vector<CID> blocks,
+                    size_t depth,
+                    ChainCb cb) {
+    TipsetKey key{blocks};
+    sendRequest(std::move(host),
+                peer,
+                {std::move(blocks), depth, Request::BLOCKS},
+                [MOVE(ipld), MOVE(key), depth, MOVE(cb)](auto _response) {
+                  if (!_response) {
+                    return cb(_response.error());
+                  }
+                  auto &packed{_response.value().chain};
+                  if (packed.size() > depth) {
+                    return cb(Error::kInconsistent);
+                  }
+                  std::vector<TipsetCPtr> chain;
+                  for (auto &tipset : packed) {
+                    auto _ts{unpackHeaders(ipld, std::move(tipset.blocks))};
+                    if (!_ts) {
+                      return cb(_ts.error());
+                    }
+                    auto &ts{_ts.value()};
+                    auto expected{chain.empty() ? key
+                                                : chain.back()->getParents()};
+                    if (ts->key != expected) {
+                      return cb(Error::kInconsistent);
+                    }
+                    chain.push_back(std::move(ts));
+                  }
+                  cb(std::move(chain));
+                });
   }
 
-  void serve(std::shared_ptr<Host> host, IpldPtr ipld) {
-    host->setProtocolHandler(kProtocolId, [MOVE(ipld)](auto _stream) {
-      auto stream{std::make_shared<CborStream>(_stream)};
-      stream->template read<Request>([stream, MOVE(ipld)](auto _request) {
-        Response response;
-        if (_request) {
-          auto &request{_request.value()};
-          if (request.blocks.empty()) {
-            response.status = Error::kBadRequest;
-            response.message = "no cids given in blocksync request";
-          } else {
-            auto partial{request.depth > kBlockSyncMaxRequestLength};
-            if (partial) {
-              request.depth = kBlockSyncMaxRequestLength;
-            }
-            auto _chain{getChain(ipld, request)};
-            if (_chain) {
-              response.chain = std::move(_chain.value());
-              response.status = partial ? Error::kPartial : Error::kOk;
-            } else {
-              response.status = Error::kInternalError;
-              response.message = _chain.error().message();
-            }
-          }
-        } else {
-          response.status = Error::kBadRequest;
-          response.message = _request.error().message();
-        }
-        stream->write(response, [stream](auto) { stream->close(); });
-      });
-    });
+  void fetchMessages(std::shared_ptr<Host> host,
+                     const PeerInfo &peer,
+                     IpldPtr ipld,
+                     std::shared_ptr<SignatureVerifier> verifier,
+                     std::vector<TipsetCPtr> chain,
+                     MessagesCb cb) {
+    if (chain.empty()) {
+      return cb(outcome::success());
+    }
+    auto blocks{chain.front()->key.cids()};
+    auto depth{chain.size()};
+    sendRequest(std::move(host),
+                peer,
+                {std::move(blocks), depth, Request::MESSAGES},
+                [MOVE(ipld), MOVE(verifier), MOVE(chain), MOVE(cb)](
+                    auto _response) {
+                  if (!_response) {
+                    return cb(_response.error());
+                  }
+                  auto &packed{_response.value().chain};
+                  if (packed.size() > chain.size()) {
+                    return cb(Error::kInconsistent);
+                  }
+                  auto bad_signature{false};
+                  for (auto i{0u}; i < packed.size(); ++i) {
+                    if (!packed[i].messages) {
+                      return cb(Error::kInconsistent);
+                    }
+                    auto _unpacked{unpackMessages(
+                        ipld, verifier, chain[i]->blks, *packed[i].messages)};
+                    if (!_unpacked) {
+                      // messages are stored, ancestors are still needed
+                      if (_unpacked.error() == Error::kBadSignature) {
+                        bad_signature = true;
+                        continue;
+                      }
+                      return cb(_unpacked.error());
+                    }
+                  }
+                  // messages of received prefix are stored, caller requests
+                  // rest again
+                  if (packed.size() < chain.size()) {
+                    return cb(Error::kPartial);
+                  }
+                  if (bad_signature) {
+                    return cb(Error::kBadSignature);
+                  }
+                  cb(outcome::success());
+                });
   }
 }  // namespace fc::blocksync
@@ -5,14 +5,24 @@
 
 #pragma once
 
+#include "codec/cbor/streams_annotation.hpp"
 #include "node/fwd.hpp"
+#include "primitives/block/block.hpp"
 
 namespace fc::blocksync {
   using libp2p::Host;
   using libp2p::peer::PeerInfo;
+  using primitives::block::BlockHeader;
+  using primitives::block::SignedMessage;
+  using primitives::block::UnsignedMessage;
   using primitives::tipset::Tipset;
+  using vm::message::SignatureVerifier;
+  using TipsetCPtr = std::shared_ptr<const Tipset>;
 
   enum class Error {
+    /// Messages match block, but some secp signature is invalid, so block is
+    /// invalid and is not fetched from other peers
+    kBadSignature = -2,
     kInconsistent = -1,
     kOk = 0,
     kPartial = 101,
@@ -22,15 +32,89 @@ namespace fc::blocksync {
     kBadRequest = 204,
   };
 
-  // TODO: depth/count
+  constexpr auto kProtocolId{"/fil/sync/blk/0.0.1"};
+
+  /// Max number of tipsets served for one request
+  constexpr size_t kBlockSyncMaxRequestLength{800};
+
+  struct Request {
+    enum Options {
+      BLOCKS = 1,
+      MESSAGES = 2,
+      BLOCKS_AND_MESSAGES = BLOCKS | MESSAGES,
+    };
+
+    std::vector<CID> blocks;
+    size_t depth{1};
+    Options options{BLOCKS_AND_MESSAGES};
+  };
+  CBOR_TUPLE(Request, blocks, depth, options)
+
+  struct Response {
+    using Indices = std::vector<std::vector<size_t>>;
+
+    struct Messages {
+      std::vector<UnsignedMessage> bls_messages;
+      Indices bls_indices;
+      std::vector<SignedMessage> secp_messages;
+      Indices secp_indices;
+    };
+
+    struct Tipset {
+      std::vector<BlockHeader> blocks;
+      boost::optional<Messages> messages;
+    };
+
+    std::vector<Tipset> chain;
+    Error status;
+    std::string message;
+  };
+  CBOR_TUPLE(Response, status, message, chain)
+  CBOR_TUPLE(Response::Tipset, blocks, messages)
+  CBOR_TUPLE(Response::Messages,
+             bls_messages,
+             bls_indices,
+             secp_messages,
+             secp_indices)
+
   using Cb = std::function<void(outcome::result<std::shared_ptr<const Tipset>>)>;
+  /// Fetches tipset, secp message signatures are checked with verifier if set
   void fetch(std::shared_ptr<Host> host,
              const PeerInfo &peer,
              IpldPtr ipld,
+             std::shared_ptr<SignatureVerifier> verifier,
              std::vector<CID> blocks,
              Cb cb);
 
-  void serve(std::shared_ptr<Host> host, IpldPtr ipld);
+  using ChainCb = std::function<void(outcome::result<std::vector<TipsetCPtr>>)>;
+  /**
+   * Fetches headers of tipset and up to depth - 1 of its ancestors, without
+   * messages.
+   * Chain is ordered from tipset to ancestors, links between tipsets are
+   * checked.
+   */
+  void fetchHeaders(std::shared_ptr<Host> host,
+                    const PeerInfo &peer,
+                    IpldPtr ipld,
+                    std::vector<CID> blocks,
+                    size_t depth,
+                    ChainCb cb);
+
+  using MessagesCb = std::function<void(outcome::result<void>)>;
+  /**
+   * Fetches messages of chain with known headers, ordered from tipset to
+   * ancestors, with one request.
+   * Messages are checked against headers, secp message signatures are checked
+   * with verifier if set.
+   * Messages of all received tipsets are stored, kBadSignature is reported
+   * after them.
+   */
+  void fetchMessages(std::shared_ptr<Host> host,
+                     const PeerInfo &peer,
+                     IpldPtr ipld,
+                     std::shared_ptr<SignatureVerifier> verifier,
+                     std::vector<TipsetCPtr> chain,
+                     MessagesCb cb);
 }  // namespace fc::blocksync
 
 OUTCOME_HPP_DECLARE_ERROR(fc::blocksync, Error)
@@ -0,0 +1,297 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "node/blocksync_fetcher.hpp"
+
+#include <algorithm>
+
+#include <libp2p/peer/peer_info.hpp>
+
+#include "primitives/tipset/tipset.hpp"
+
+#define MOVE(x)  \
+  x {            \
+    std::move(x) \
+  }
+
+namespace fc::blocksync {
+  namespace {
+    /// Number of leading tipsets of chain which messages are stored
+    size_t storedPrefix(const IpldPtr &ipld,
+                        const std::vector<TipsetCPtr> &chain) {
+      auto i{0u};
+      for (; i < chain.size(); ++i) {
+        for (auto &block : chain[i]->blks) {
+          auto _have{ipld->contains(block.messages)};
+          if (!_have || !_have.value()) {
+            return i;
+          }
+        }
+      }
+      return i;
+    }
+  }  // namespace
+
+  double Fetcher::PeerStats::tipsetsPerSecond() const {
+    if (time.count() == 0) {
+      return 0;
+    }
+    return tipsets / std::chrono::duration<double>(time).count();
+  }
+
+  std::shared_ptr<Fetcher> Fetcher::make(
+      std::shared_ptr<Host> host,
+      IpldPtr ipld,
+      std::shared_ptr<SignatureVerifier> verifier,
+      size_t window,
+      size_t max_tries) {
+    return make(
+        [host, ipld](auto &peer, auto &key, auto depth, auto cb) {
+          fetchHeaders(
+              host, {peer, {}}, ipld, key.cids(), depth, std::move(cb));
+        },
+        [host, ipld, verifier](auto &peer, auto &chain, auto cb) {
+          fetchMessages(
+              host, {peer, {}}, ipld, verifier, chain, std::move(cb));
+        },
+        ipld,
+        window,
+        max_tries);
+  }
+
+  std::shared_ptr<Fetcher> Fetcher::make(SendHeaders send_headers,
+                                         SendMessages send_messages,
+                                         IpldPtr ipld,
+                                         size_t window,
+                                         size_t max_tries) {
+    return std::shared_ptr<Fetcher>{new Fetcher{std::move(send_headers),
+                                                std::move(send_messages),
+                                                std::move(ipld),
+                                                window,
+                                                max_tries}};
+  }
+
+  Fetcher::Fetcher(SendHeaders send_headers,
+                   SendMessages send_messages,
+                   IpldPtr ipld,
+                   size_t window,
+                   size_t max_tries)
+      : send_headers_{std::move(send_headers)},
+        send_messages_{std::move(send_messages)},
+        ipld_{std::move(ipld)},
+        window_{window},
+        max_tries_{max_tries} {}
+
+  void Fetcher::addPeer(const PeerId &peer) {
+    {
+      std::lock_guard lock{mutex_};
+      for (auto &_peer : peers_) {
+        if (_peer.stats.peer == peer) {
+          return;
+        }
+      }
+      peers_.push_back({{peer}});
+    }
+    schedule();
+  }
+
+  void Fetcher::removePeer(const PeerId &peer) {
+    std::lock_guard lock{mutex_};
+    peers_.erase(std::remove_if(peers_.begin(),
+                                peers_.end(),
+                                [&](auto &_peer) {
+                                  return _peer.stats.peer == peer;
+                                }),
+                 peers_.end());
+  }
+
+  void Fetcher::headers(const TipsetKey &key,
+                        size_t depth,
+                        const boost::optional<PeerId> &prefer,
+                        ChainCb cb) {
+    auto shared_cb{std::make_shared<ChainCb>(std::move(cb))};
+    enqueue({[self{shared_from_this()}, key, depth, shared_cb](auto &peer,
+                                                              auto done) {
+               self->send_headers_(
+                   peer, key, depth, [shared_cb, MOVE(done)](auto _chain) {
+                     if (!_chain) {
+                       return done(_chain.error());
+                     }
+                     auto count{_chain.value().size()};
+                     (*shared_cb)(std::move(_chain));
+                     done(count);
+                   });
+             },
+             [shared_cb](auto error) { (*shared_cb)(error); },
+             prefer});
+  }
+
+  void Fetcher::messages(std::vector<TipsetCPtr> chain,
+                         const boost::optional<PeerId> &prefer,
+                         MessagesCb cb) {
+    messages(std::move(chain),
+             prefer,
+             std::make_shared<MessagesCb>(std::move(cb)));
+  }
+
+  void Fetcher::messages(std::vector<TipsetCPtr> chain,
+                         const boost::optional<PeerId> &prefer,
+                         std::shared_ptr<MessagesCb> cb) {
+    enqueue({[self{shared_from_this()}, chain, cb](auto &peer, auto done) {
+               self->send_messages_(
+                   peer,
+                   chain,
+                   [self, chain, cb, peer, MOVE(done)](auto _messages) {
+                     if (!_messages
+                         && _messages.error() == Error::kBadSignature) {
+                       // messages are stored, other peers send same block
+                       (*cb)(_messages.error());
+                       return done(chain.size());
+                     }
+                     if (!_messages) {
+                       auto stored{
+                           _messages.error() == Error::kPartial
+                               ? storedPrefix(self->ipld_, chain)
+                               : 0};
+                       if (stored == 0) {
+                         return done(_messages.error());
+                       }
+                       // received prefix is stored, only rest is requested
+                       // again, with new tries
+                       done(stored);
+                       return self->messages(
+                           {chain.begin() + stored, chain.end()}, peer, cb);
+                     }
+                     (*cb)(outcome::success());
+                     done(chain.size());
+                   });
+             },
+             [cb](auto error) { (*cb)(error); },
+             prefer});
+  }
+
+  size_t Fetcher::inFlight() const {
+    std::lock_guard lock{mutex_};
+    return in_flight_;
+  }
+
+  std::vector<Fetcher::PeerStats> Fetcher::stats() const {
+    std::lock_guard lock{mutex_};
+    std::vector<PeerStats> stats;
+    for (auto &peer : peers_) {
+      stats.push_back(peer.stats);
+    }
+    return stats;
+  }
+
+  void Fetcher::enqueue(Job job) {
+    {
+      std::lock_guard lock{mutex_};
+      queue_.push_back(std::move(job));
+    }
+    schedule();
+  }
+
+  void Fetcher::schedule() {
+    std::vector<std::pair<Job, PeerId>> send;
+    std::vector<Job> fail;
+    {
+      std::lock_guard lock{mutex_};
+      while (in_flight_ < window_ && !queue_.empty()) {
+        auto job{std::move(queue_.front())};
+        queue_.pop_front();
+        auto peer{choose(job)};
+        if (!peer) {
+          fail.push_back(std::move(job));
+          continue;
+        }
+        ++peer->in_flight;
+        ++in_flight_;
+        send.emplace_back(std::move(job), peer->stats.peer);
+      }
+    }
+    for (auto &job : fail) {
+      job.fail(job.error);
+    }
+    for (auto &item : send) {
+      auto start{std::chrono::steady_clock::now()};
+      auto send_fn{item.first.send};
+      send_fn(item.second,
+              [self{shared_from_this()},
+               job{std::move(item.first)},
+               peer{item.second},
+               start](auto result) mutable {
+                self->done(std::move(job), peer, start, std::move(result));
+              });
+    }
+  }
+
+  Fetcher::Peer *Fetcher::choose(const Job &job) {
+    auto tried{[&](auto &peer) {
+      return std::find(job.tried.begin(), job.tried.end(), peer)
+             != job.tried.end();
+    }};
+    Peer *best{nullptr};
+    for (auto &peer : peers_) {
+      if (tried(peer.stats.peer)) {
+        continue;
+      }
+      if (job.prefer && peer.stats.peer == *job.prefer) {
+        return &peer;
+      }
+      if (!best || peer.in_flight < best->in_flight
+          || (peer.in_flight == best->in_flight
+              && peer.stats.tipsetsPerSecond()
+                     > best->stats.tipsetsPerSecond())) {
+        best = &peer;
+      }
+    }
+    return best;
+  }
+
+  void Fetcher::done(Job job,
+                     const PeerId &peer,
+                     std::chrono::steady_clock::time_point start,
+                     outcome::result<size_t> result) {
+    auto failed{false}, unresponsive{false};
+    {
+      std::lock_guard lock{mutex_};
+      --in_flight_;
+      for (auto &_peer : peers_) {
+        if (_peer.stats.peer == peer) {
+          --_peer.in_flight;
+          ++_peer.stats.requests;
+          _peer.stats.time += std::chrono::steady_clock::now() - start;
+          if (result) {
+            _peer.stats.tipsets += result.value();
+            _peer.failures_in_row = 0;
+          } else {
+            ++_peer.stats.failures;
+            ++_peer.failures_in_row;
+            unresponsive = _peer.failures_in_row >= kMaxPeerFailures;
+          }
+          break;
+        }
+      }
+      if (!result) {
+        job.tried.push_back(peer);
+        job.error = result.error();
+        if (job.tried.size() < max_tries_) {
+          queue_.push_front(std::move(job));
+        } else {
+          failed = true;
+        }
+      }
+    }
+    if (unresponsive) {
+      // unresponsive peer is not chosen again
+      removePeer(peer);
+    }
+    if (failed) {
+      job.fail(job.error);
+    }
+    schedule();
+  }
+}  // namespace fc::blocksync
@@ -0,0 +1,147 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#include <boost/optional.hpp>
+#include <libp2p/peer/peer_id.hpp>
+
+#include "node/blocksync.hpp"
+#include "primitives/tipset/tipset_key.hpp"
+
+namespace fc::blocksync {
+  using libp2p::peer::PeerId;
+  using primitives::tipset::TipsetKey;
+
+  /**
+   * Schedules blocksync requests over several peers.
+   * Keeps window of requests in flight, prefers least loaded and fastest
+   * peers, retries failed requests on other peers. Peer is removed after
+   * kMaxPeerFailures failed requests in a row, until it is added again.
+   */
+  class Fetcher : public std::enable_shared_from_this<Fetcher> {
+   public:
+    /// Default max number of requests in flight over all peers
+    static constexpr size_t kDefaultWindow{8};
+    /// Default number of peers tried before request fails
+    static constexpr size_t kDefaultMaxTries{3};
+    /// Number of failed requests in a row after which peer is removed
+    static constexpr size_t kMaxPeerFailures{5};
+
+    struct PeerStats {
+      PeerId peer;
+      size_t requests{}, failures{}, tipsets{};
+      /// Total time of requests
+      std::chrono::nanoseconds time{};
+
+      double tipsetsPerSecond() const;
+    };
+
+    /// Sends headers request to peer, see fetchHeaders
+    using SendHeaders = std::function<void(
+        const PeerId &, const TipsetKey &, size_t depth, ChainCb)>;
+    /// Sends messages request to peer, see fetchMessages
+    using SendMessages = std::function<void(
+        const PeerId &, const std::vector<TipsetCPtr> &, MessagesCb)>;
+
+    /// Creates fetcher sending requests over host
+    static std::shared_ptr<Fetcher> make(
+        std::shared_ptr<Host> host,
+        IpldPtr ipld,
+        std::shared_ptr<SignatureVerifier> verifier,
+        size_t window = kDefaultWindow,
+        size_t max_tries = kDefaultMaxTries);
+
+    /// Creates fetcher sending requests with given functions, ipld is store
+    /// messages are saved to
+    static std::shared_ptr<Fetcher> make(SendHeaders send_headers,
+                                         SendMessages send_messages,
+                                         IpldPtr ipld,
+                                         size_t window = kDefaultWindow,
+                                         size_t max_tries = kDefaultMaxTries);
+
+    /// Adds peer requests may be sent to
+    void addPeer(const PeerId &peer);
+
+    /// Removes peer, requests in flight to it are completed
+    void removePeer(const PeerId &peer);
+
+    /// Fetches headers of tipset and ancestors, see fetchHeaders, tries
+    /// preferred peer first
+    void headers(const TipsetKey &key,
+                 size_t depth,
+                 const boost::optional<PeerId> &prefer,
+                 ChainCb cb);
+
+    /// Fetches messages of chain, see fetchMessages, rest of partial response
+    /// is requested again, kBadSignature is not retried
+    void messages(std::vector<TipsetCPtr> chain,
+                  const boost::optional<PeerId> &prefer,
+                  MessagesCb cb);
+
+    /// Number of requests in flight
+    size_t inFlight() const;
+
+    std::vector<PeerStats> stats() const;
+
+   private:
+    using Done = std::function<void(outcome::result<size_t>)>;
+
+    struct Job {
+      /// Sends request to peer, calls done with number of received tipsets
+      std::function<void(const PeerId &, Done)> send;
+      /// Called when all tries failed
+      std::function<void(std::error_code)> fail;
+      boost::optional<PeerId> prefer;
+      std::vector<PeerId> tried{};
+      /// Error of last try
+      std::error_code error{Error::kNotFound};
+    };
+
+    struct Peer {
+      PeerStats stats;
+      size_t in_flight{};
+      /// Failed requests since last success
+      size_t failures_in_row{};
+    };
+
+    Fetcher(SendHeaders send_headers,
+            SendMessages send_messages,
+            IpldPtr ipld,
+            size_t window,
+            size_t max_tries);
+
+    void messages(std::vector<TipsetCPtr> chain,
+                  const boost::optional<PeerId> &prefer,
+                  std::shared_ptr<MessagesCb> cb);
+
+    void enqueue(Job job);
+
+    /// Sends queued jobs while window allows
+    void schedule();
+
+    /// Chooses untried peer for job, mutex must be locked
+    Peer *choose(const Job &job);
+
+    void done(Job job,
+              const PeerId &peer,
+              std::chrono::steady_clock::time_point start,
+              outcome::result<size_t> result);
+
+    SendHeaders send_headers_;
+    SendMessages send_messages_;
+    IpldPtr ipld_;
+    size_t window_, max_tries_;
+
+    mutable std::mutex mutex_;
+    std::vector<Peer> peers_;
+    std::deque<Job> queue_;
+    size_t in_flight_{};
+  };
+}  // namespace fc::blocksync
@@ -0,0 +1,252 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "node/blocksync_server.hpp"
+
+#include <libp2p/host/host.hpp>
+
+#include "primitives/tipset/tipset.hpp"
+
+namespace fc::blocksync {
+  using primitives::block::MsgMeta;
+
+  namespace {
+    template <typename T>
+    struct MessageVisitor {
+      outcome::result<void> operator()(size_t, const CID &cid) {
+        auto index{visited.find(cid)};
+        if (index == visited.end()) {
+          index = visited.emplace(cid, messages.size()).first;
+          OUTCOME_TRY(message, ipld->getCbor<T>(cid));
+          messages.push_back(std::move(message));
+        }
+        indices.rbegin()->push_back(index->second);
+        return outcome::success();
+      }
+
+      const IpldPtr &ipld;
+      std::vector<T> &messages;
+      Response::Indices &indices;
+      std::map<CID, size_t> visited{};
+    };
+
+    outcome::result<Response::Tipset> packTipset(const IpldPtr &ipld,
+                                                 const Tipset &ts,
+                                                 Request::Options options) {
+      Response::Tipset packed;
+      if (options & Request::MESSAGES) {
+        Response::Messages msgs;
+        MessageVisitor<UnsignedMessage> bls_visitor{
+            ipld, msgs.bls_messages, msgs.bls_indices};
+        MessageVisitor<SignedMessage> secp_visitor{
+            ipld, msgs.secp_messages, msgs.secp_indices};
+        for (auto &block : ts.blks) {
+          OUTCOME_TRY(meta, ipld->getCbor<MsgMeta>(block.messages));
+          msgs.bls_indices.emplace_back();
+          OUTCOME_TRY(meta.bls_messages.visit(bls_visitor));
+          msgs.secp_indices.emplace_back();
+          OUTCOME_TRY(meta.secp_messages.visit(secp_visitor));
+        }
+        packed.messages = std::move(msgs);
+      }
+      if (options & Request::BLOCKS) {
+        packed.blocks = ts.blks;
+      }
+      return std::move(packed);
+    }
+  }  // namespace
+
+  std::shared_ptr<Server> Server::make(std::shared_ptr<Host> host,
+                                       IpldPtr ipld,
+                                       size_t cache_bytes,
+                                       size_t peer_rate) {
+    return std::shared_ptr<Server>{new Server{
+        std::move(host), std::move(ipld), cache_bytes, peer_rate}};
+  }
+
+  Server::Server(std::shared_ptr<Host> host,
+                 IpldPtr ipld,
+                 size_t cache_bytes,
+                 size_t peer_rate)
+      : host_{std::move(host)},
+        ipld_{std::move(ipld)},
+        peer_rate_{peer_rate},
+        cache_{cache_bytes, [](auto &bytes) { return bytes->size(); }},
+        buckets_{kMaxPeers} {}
+
+  void Server::start() {
+    host_->setProtocolHandler(
+        kProtocolId, [weak{weak_from_this()}](auto _stream) {
+          auto stream{std::make_shared<CborStream>(_stream)};
+          stream->template read<Request>([weak, stream](auto _request) {
+            if (auto self{weak.lock()}) {
+              return self->handle(stream, std::move(_request));
+            }
+            stream->stream()->reset();
+          });
+        });
+  }
+
+  outcome::result<std::shared_ptr<const Buffer>> Server::pack(
+      const Tipset &ts, Request::Options options) {
+    auto key{Buffer{}.put(ts.key.hash()).putUint8(options)};
+    {
+      std::lock_guard lock{mutex_};
+      if (auto bytes{cache_.get(key)}) {
+        ++stats_.cache_hits;
+        return *bytes;
+      }
+      ++stats_.cache_misses;
+    }
+    OUTCOME_TRY(packed, packTipset(ipld_, ts, options));
+    OUTCOME_TRY(encoded, codec::cbor::encode(packed));
+    auto bytes{std::make_shared<const Buffer>(std::move(encoded))};
+    std::lock_guard lock{mutex_};
+    cache_.put(key, bytes);
+    return bytes;
+  }
+
+  outcome::result<Buffer> Server::encodePrefix(Error status, size_t n) {
+    OUTCOME_TRY(empty, codec::cbor::encode(Response{{}, status, {}}));
+    // empty chain list is last byte, it is replaced with list header
+    Buffer prefix;
+    prefix.put(gsl::make_span(empty).subspan(0, empty.size() - 1));
+    constexpr uint8_t kList{0x80};
+    if (n < 24) {
+      prefix.putUint8(kList | n);
+    } else if (n <= 0xFF) {
+      prefix.putUint8(kList | 24).putUint8(n);
+    } else if (n <= 0xFFFF) {
+      prefix.putUint8(kList | 25).putUint8(n >> 8).putUint8(n & 0xFF);
+    } else {
+      prefix.putUint8(kList | 26).putUint32(n);
+    }
+    return prefix;
+  }
+
+  bool Server::allow(const Buffer &peer, size_t tipsets) {
+    auto now{Clock::now()};
+    std::lock_guard lock{mutex_};
+    auto bucket{buckets_.get(peer).value_or(
+        Bucket{static_cast<double>(peer_rate_), now})};
+    bucket.tokens = std::min<double>(
+        peer_rate_,
+        bucket.tokens
+            + std::chrono::duration<double>(now - bucket.time).count()
+                  * peer_rate_);
+    bucket.time = now;
+    auto allowed{bucket.tokens >= tipsets};
+    if (allowed) {
+      bucket.tokens -= tipsets;
+    } else {
+      ++stats_.rate_limited;
+    }
+    buckets_.put(peer, bucket);
+    return allowed;
+  }
+
+  Server::Stats Server::stats() const {
+    std::lock_guard lock{mutex_};
+    return stats_;
+  }
+
+  void Server::handle(std::shared_ptr<CborStream> stream,
+                      outcome::result<Request> _request) {
+    {
+      std::lock_guard lock{mutex_};
+      ++stats_.requests;
+    }
+    auto error{[&](Error status, std::string message) {
+      {
+        std::lock_guard lock{mutex_};
+        ++stats_.failed;
+      }
+      stream->write(Response{{}, status, std::move(message)},
+                    [stream](auto) { stream->close(); });
+    }};
+    if (!_request) {
+      return error(Error::kBadRequest, _request.error().message());
+    }
+    auto &request{_request.value()};
+    if (request.blocks.empty()) {
+      return error(Error::kBadRequest, "no cids given in blocksync request");
+    }
+    auto partial{request.depth > kBlockSyncMaxRequestLength};
+    if (partial) {
+      request.depth = kBlockSyncMaxRequestLength;
+    }
+    // limited before chain is loaded, so rejected requests cost nothing
+    auto _peer{stream->stream()->remotePeerId()};
+    if (!_peer || !allow(Buffer{_peer.value().toVector()}, request.depth)) {
+      return error(Error::kGoAway, "blocksync rate limit exceeded");
+    }
+    auto chain{std::make_shared<std::vector<TipsetCPtr>>()};
+    auto _ts{Tipset::load(*ipld_, request.blocks)};
+    if (!_ts) {
+      return error(Error::kNotFound, _ts.error().message());
+    }
+    chain->push_back(std::move(_ts.value()));
+    while (chain->size() < request.depth && chain->back()->height() != 0) {
+      auto _parent{chain->back()->loadParent(*ipld_)};
+      if (!_parent) {
+        return error(Error::kInternalError, _parent.error().message());
+      }
+      chain->push_back(std::move(_parent.value()));
+    }
+    auto _prefix{
+        encodePrefix(partial ? Error::kPartial : Error::kOk, chain->size())};
+    if (!_prefix) {
+      return error(Error::kInternalError, _prefix.error().message());
+    }
+    auto prefix{std::make_shared<Buffer>(std::move(_prefix.value()))};
+    stream->writeRaw(
+        *prefix,
+        [self{shared_from_this()}, stream, prefix, chain, request](auto _n) {
+          if (!_n) {
+            return stream->stream()->reset();
+          }
+          self->writeChain(stream, chain, 0, request.options);
+        });
+  }
+
+  void Server::writeChain(std::shared_ptr<CborStream> stream,
+                          std::shared_ptr<std::vector<TipsetCPtr>> chain,
+                          size_t i,
+                          Request::Options options) {
+    if (i == chain->size()) {
+      return stream->close();
+    }
+    auto _bytes{pack(*chain->at(i), options)};
+    if (!_bytes) {
+      // status is already written, client sees truncated response
+      {
+        std::lock_guard lock{mutex_};
+        ++stats_.failed;
+      }
+      return stream->stream()->reset();
+    }
+    auto bytes{_bytes.value()};
+    {
+      std::lock_guard lock{mutex_};
+      ++stats_.tipsets;
+      stats_.bytes += bytes->size();
+    }
+    stream->writeRaw(
+        *bytes,
+        [self{shared_from_this()}, stream, chain, i, options, bytes](
+            auto _n) {
+          if (!_n) {
+            return stream->stream()->reset();
+          }
+          self->writeChain(stream, chain, i + 1, options);
+        });
+  }
+
+  std::shared_ptr<Server> serve(std::shared_ptr<Host> host, IpldPtr ipld) {
+    auto server{Server::make(std::move(host), std::move(ipld))};
+    server->start();
+    return server;
+  }
+}  // namespace fc::blocksync
@@ -0,0 +1,96 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+#include "common/libp2p/cbor_stream.hpp"
+#include "common/lru_cache.hpp"
+#include "node/blocksync.hpp"
+
+namespace fc::blocksync {
+  using common::Buffer;
+  using common::libp2p::CborStream;
+
+  /**
+   * Serves blocksync requests.
+   * Packed tipsets are encoded once and cached, as many peers request same
+   * recent tipsets. Response is written while tipsets are packed. Number of
+   * tipsets requested by each peer is rate limited before chain is loaded.
+   */
+  class Server : public std::enable_shared_from_this<Server> {
+   public:
+    /// Default limit of cached bytes of encoded tipsets
+    static constexpr size_t kDefaultCacheBytes{64 << 20};
+    /// Default number of tipsets per second served to one peer, it is also
+    /// max burst
+    static constexpr size_t kDefaultPeerRate{4 * kBlockSyncMaxRequestLength};
+    /// Max number of peers rates are tracked for
+    static constexpr size_t kMaxPeers{1024};
+
+    struct Stats {
+      size_t requests{}, rate_limited{}, failed{};
+      size_t tipsets{}, bytes{}, cache_hits{}, cache_misses{};
+    };
+
+    static std::shared_ptr<Server> make(std::shared_ptr<Host> host,
+                                        IpldPtr ipld,
+                                        size_t cache_bytes = kDefaultCacheBytes,
+                                        size_t peer_rate = kDefaultPeerRate);
+
+    /// Handles blocksync protocol of host
+    void start();
+
+    /// Returns encoded packed tipset, it's cached
+    outcome::result<std::shared_ptr<const Buffer>> pack(
+        const Tipset &ts, Request::Options options);
+
+    /**
+     * Encodes response with status and chain of n tipsets, without tipsets.
+     * Encoded tipsets written after it form same bytes as encoded response.
+     */
+    static outcome::result<Buffer> encodePrefix(Error status, size_t n);
+
+    /// Takes tokens for tipsets from peer bucket, false if peer exceeds rate
+    bool allow(const Buffer &peer, size_t tipsets);
+
+    Stats stats() const;
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Bucket {
+      double tokens;
+      Clock::time_point time;
+    };
+
+    Server(std::shared_ptr<Host> host,
+           IpldPtr ipld,
+           size_t cache_bytes,
+           size_t peer_rate);
+
+    void handle(std::shared_ptr<CborStream> stream,
+                outcome::result<Request> _request);
+
+    void writeChain(std::shared_ptr<CborStream> stream,
+                    std::shared_ptr<std::vector<TipsetCPtr>> chain,
+                    size_t i,
+                    Request::Options options);
+
+    std::shared_ptr<Host> host_;
+    IpldPtr ipld_;
+    size_t peer_rate_;
+
+    mutable std::mutex mutex_;
+    common::LruCache<Buffer, std::shared_ptr<const Buffer>> cache_;
+    common::LruCache<Buffer, Bucket> buckets_;
+    Stats stats_;
+  };
+
+  /// Serves blocksync requests with default limits
+  std::shared_ptr<Server> serve(std::shared_ptr<Host> host, IpldPtr ipld);
+}  // namespace fc::blocksync
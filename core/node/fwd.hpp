@@ -111,9 +111,11 @@ namespace fc {
 
     namespace interpreter {
       class Interpreter;
+      struct Result;
     }  // namespace interpreter
 
     namespace message {
+      class SignatureVerifier;
       struct SignedMessage;
       struct UnsignedMessage;
     }  // namespace message
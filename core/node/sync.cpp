@@ -3,13 +3,24 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
 #include <libp2p/peer/peer_info.hpp>
+#include <spdlog/spdlog.h>
 
+#include "blockchain/block_validator/impl/bls_aggregate_verifier.hpp"
+#include "blockchain/block_validator/impl/header_validator.hpp"
+#include "blockchain/impl/cached_weight_calculator.hpp"
 #include "blockchain/impl/weight_calculator_impl.hpp"
 #include "node/blocksync.hpp"
+#include "node/blocksync_fetcher.hpp"
 #include "node/sync.hpp"
 #include "storage/chain/chain_store.hpp"
-#include "vm/interpreter/interpreter.hpp"
+#include "storage/ipfs/ipfs_datastore_error.hpp"
+#include "vm/interpreter/impl/interpreter_impl.hpp"
+#include "vm/message/signature_verifier.hpp"
+#include "vm/runtime/env.hpp"
+#include "vm/state/impl/state_tree_impl.hpp"
 
 #define MOVE(x)  \
   x {            \
@@ -17,61 +28,232 @@
   }
 
 namespace fc::sync {
+  using blockchain::weight::CachedWeightCalculator;
+  using drand::BeaconEntry;
   using primitives::block::MsgMeta;
   using primitives::tipset::Tipset;
+  using primitives::tipset::TipsetCPtr;
+  using vm::interpreter::CachedInterpreter;
+  using vm::interpreter::isConsensusFailure;
+  using vm::message::SignatureVerifier;
+  using vm::message::SignedMessage;
+  using vm::state::StateTreeImpl;
 
   TsSync::TsSync(std::shared_ptr<Host> host,
                  IpldPtr ipld,
-                 std::shared_ptr<Interpreter> interpreter)
-      : MOVE(host), MOVE(ipld), MOVE(interpreter) {}
+                 std::shared_ptr<Interpreter> interpreter,
+                 std::shared_ptr<SignatureVerifier> verifier,
+                 std::shared_ptr<HeaderValidator> header_validator,
+                 std::shared_ptr<BlsAggregateVerifier> bls_verifier,
+                 std::shared_ptr<ValidityStore> valid,
+                 std::shared_ptr<WeightCalculator> weight_calculator,
+                 std::shared_ptr<boost::asio::io_context> io,
+                 size_t max_branches)
+      : MOVE(host),
+        MOVE(ipld),
+        MOVE(interpreter),
+        MOVE(verifier),
+        MOVE(header_validator),
+        MOVE(bls_verifier),
+        fetcher{blocksync::Fetcher::make(
+            this->host, this->ipld, this->verifier)},
+        MOVE(valid),
+        MOVE(weight_calculator),
+        MOVE(io) {
+    if (max_branches > 1) {
+      branch_pool = std::make_unique<boost::asio::thread_pool>(max_branches);
+    }
+  }
 
   void TsSync::sync(const TipsetKey &key,
                     const PeerId &peer,
                     Callback callback) {
-    auto _valid{valid.find(key)};
-    if (_valid != valid.end()) {
-      return callback(key, _valid->second);
+    if (auto _valid{isValid(key)}) {
+      return callback(key, *_valid);
+    }
+    fetcher->addPeer(peer);
+    auto &_callbacks{callbacks[key]};
+    _callbacks.push_back(std::move(callback));
+    if (_callbacks.size() != 1) {
+      // tipset is already being synced
+      return;
+    }
+    if (walks >= kMaxWalks) {
+      // validity is unknown, it is not persisted
+      auto dropped{std::move(_callbacks.back())};
+      callbacks.erase(key);
+      return dropped(key, false);
     }
-    callbacks[key].push_back(std::move(callback));
     walkDown(key, peer);
   }
 
   void TsSync::walkDown(TipsetKey key, const PeerId &peer) {
+    ++walks;
+    walkHeaders(std::make_shared<Walk>(Walk{key, peer, key}));
+  }
+
+  void TsSync::walkHeaders(std::shared_ptr<Walk> walk) {
     while (true) {
-      auto _ts{Tipset::load(*ipld, key.cids())};
-      if (_ts) {
-        auto &ts{_ts.value()};
-        auto have_messages{true};
-        for (auto &block : ts->blks) {
-          auto _have{ipld->contains(block.messages)};
-          if (!_have || !_have.value()) {
-            have_messages = false;
-            break;
-          }
+      auto _ts{Tipset::load(*ipld, walk->key.cids())};
+      if (!_ts) {
+        return fetcher->headers(
+            walk->key,
+            blocksync::kBlockSyncMaxRequestLength,
+            walk->peer,
+            [self{shared_from_this()}, walk](auto _chain) {
+              if (!_chain) {
+                // TODO: bad block vs network failure
+                spdlog::warn("TsSync: headers of {} not fetched: {}",
+                             walk->key.toPrettyString(),
+                             _chain.error().message());
+                return self->failWalk(walk);
+              }
+              self->walkHeaders(walk);
+            });
+      }
+      auto parent{_ts.value()->getParents()};
+      walk->chain.push_back(std::move(_ts.value()));
+      if (isValid(parent) || children.find(parent) != children.end()
+          || branches.count(parent) != 0) {
+        auto _parent{Tipset::load(*ipld, parent.cids())};
+        if (!_parent) {
+          spdlog::error("TsSync: known tipset {} not loaded: {}",
+                        parent.toPrettyString(),
+                        _parent.error().message());
+          return failWalk(walk);
         }
-        if (have_messages) {
-          auto parent{ts->getParents()};
-          children[parent].push_back(std::move(key));
-          if (children.at(parent).size() != 1) {
-            return;
-          }
-          if (valid.find(parent) != valid.end()) {
-            return walkUp(std::move(parent));
-          }
-          key = std::move(parent);
-          continue;
+        walk->chain.push_back(std::move(_parent.value()));
+        break;
+      }
+      walk->key = std::move(parent);
+    }
+    if (checkHeaders(walk)) {
+      fetchMessages(walk);
+    }
+  }
+
+  bool TsSync::checkHeaders(const std::shared_ptr<Walk> &walk) {
+    if (!header_validator) {
+      return true;
+    }
+    auto &chain{walk->chain};
+    boost::optional<BeaconEntry> beacon;
+    if (auto _beacon{chain.back()->latestBeacon(*ipld)}) {
+      beacon = std::move(_beacon.value());
+    }
+    auto results{header_validator->validate(chain, beacon)};
+    for (auto i{results.size()}; i != 0; --i) {
+      auto &result{results[i - 1]};
+      if (!result) {
+        spdlog::warn("TsSync: rejected {} tipsets, bad headers of {}: {}",
+                     i,
+                     chain[i - 1]->key.toPrettyString(),
+                     result.error().message());
+        // descendants of bad tipset are bad too
+        for (auto j{0u}; j < i; ++j) {
+          setValid(chain[j]->key, false, chain[j]->height());
         }
+        --walks;
+        for (auto j{i}; j != 0; --j) {
+          walkUp(chain[j - 1]->key);
+        }
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void TsSync::fetchMessages(const std::shared_ptr<Walk> &walk) {
+    auto &chain{walk->chain};
+    std::vector<TipsetCPtr> batch;
+    auto flush{[&] {
+      if (batch.empty()) {
+        return;
+      }
+      ++walk->pending;
+      fetcher->messages(std::move(batch),
+                        walk->peer,
+                        [self{shared_from_this()}, walk](auto _messages) {
+                          --walk->pending;
+                          // tipset with bad signature is marked invalid by
+                          // walkUp, messages of chain are stored
+                          if (!_messages
+                              && _messages.error()
+                                     != blocksync::Error::kBadSignature) {
+                            spdlog::warn("TsSync: messages not fetched: {}",
+                                         _messages.error().message());
+                            return self->failWalk(walk);
+                          }
+                          self->finishWalk(walk);
+                        });
+      batch.clear();
+    }};
+    // consecutive tipsets without messages are fetched with one request
+    for (auto i{0u}; i + 1 < chain.size(); ++i) {
+      auto have_messages{true};
+      for (auto &block : chain[i]->blks) {
+        auto _have{ipld->contains(block.messages)};
+        if (!_have || !_have.value()) {
+          have_messages = false;
+          break;
+        }
+      }
+      if (have_messages) {
+        flush();
+      } else {
+        batch.push_back(chain[i]);
+        if (batch.size() >= kMessagesDepth) {
+          flush();
+        }
+      }
+    }
+    flush();
+    walk->dispatched = true;
+    finishWalk(walk);
+  }
+
+  void TsSync::finishWalk(const std::shared_ptr<Walk> &walk) {
+    if (!walk->dispatched || walk->pending != 0 || walk->failed) {
+      return;
+    }
+    --walks;
+    for (auto &stats : fetcher->stats()) {
+      if (stats.peer == walk->peer) {
+        spdlog::debug(
+            "TsSync: peer {} {} requests, {} failed, {:.1f} tipsets/sec",
+            stats.peer.toBase58(),
+            stats.requests,
+            stats.failures,
+            stats.tipsetsPerSecond());
+        break;
+      }
+    }
+    auto chain{std::move(walk->chain)};
+    for (auto i{0u}; i + 1 < chain.size(); ++i) {
+      auto parent{chain[i + 1]->key};
+      children[parent].push_back(chain[i]->key);
+      if (children.at(parent).size() != 1) {
+        return;
+      }
+      if (isValid(parent)) {
+        return walkUp(std::move(parent));
+      }
+    }
+  }
+
+  void TsSync::failWalk(const std::shared_ptr<Walk> &walk) {
+    if (walk->failed) {
+      return;
+    }
+    walk->failed = true;
+    --walks;
+    auto _callbacks{callbacks.find(walk->top)};
+    if (_callbacks != callbacks.end()) {
+      auto __callbacks{std::move(_callbacks->second)};
+      callbacks.erase(_callbacks);
+      for (auto &callback : __callbacks) {
+        callback(walk->top, false);
       }
-      return blocksync::fetch(host,
-                              {peer, {}},
-                              ipld,
-                              key.cids(),
-                              [self{shared_from_this()}, key, peer](auto _ts) {
-                                // TODO: bad block vs network failure
-                                if (_ts) {
-                                  self->walkDown(std::move(key), peer);
-                                }
-                              });
     }
   }
 
@@ -80,7 +262,12 @@ namespace fc::sync {
     while (!queue.empty()) {
       key = std::move(queue.back());
       queue.pop_back();
-      auto _valid{valid.at(key)};
+      auto __valid{isValid(key)};
+      if (!__valid) {
+        abandon(key);
+        continue;
+      }
+      auto _valid{*__valid};
       auto _callbacks{callbacks.find(key)};
       if (_callbacks != callbacks.end()) {
         for (auto &callback : _callbacks->second) {
@@ -91,30 +278,134 @@ namespace fc::sync {
       auto _children{children.find(key)};
       if (_children != children.end()) {
         if (_valid) {
-          OUTCOME_EXCEPT(ts, Tipset::load(*ipld, key.cids()));
-          blockchain::weight::WeightCalculatorImpl weighter{ipld};
-          OUTCOME_EXCEPT(weight, weighter.calculateWeight(*ts));
-          OUTCOME_EXCEPT(vm, interpreter->interpret(ipld, ts));
-          for (auto &_child : _children->second) {
-            OUTCOME_EXCEPT(child, Tipset::load(*ipld, _child.cids()));
-            auto child_valid{child->getParentStateRoot() == vm.state_root
-                             && child->getParentMessageReceipts()
-                                    == vm.message_receipts
-                             && child->getParentWeight() == weight};
-            if (child_valid) {
-              auto _vm{interpreter->interpret(ipld, child)};
-              auto _weight{weighter.calculateWeight(*child)};
-              if (!_vm || !_weight) {
-                child_valid = false;
+          BigInt weight;
+          vm::interpreter::Result vm;
+          auto _executed{[&]() -> outcome::result<void> {
+            OUTCOME_TRY(ts, Tipset::load(*ipld, key.cids()));
+            OUTCOME_TRYA(weight, weight_calculator->calculateWeight(*ts));
+            OUTCOME_TRYA(vm, interpreter->interpret(ipld, ts));
+            return outcome::success();
+          }()};
+          if (!_executed) {
+            spdlog::error("TsSync: valid tipset {} not executed: {}",
+                          key.toPrettyString(),
+                          _executed.error().message());
+            abandon(key);
+            continue;
+          }
+          if (replayChain(key, weight, vm, queue)) {
+            continue;
+          }
+          // callbacks may change children
+          auto __children{std::move(_children->second)};
+          children.erase(_children);
+          // competing forks don't wait for each other
+          auto parallel{branch_pool && __children.size() > 1};
+          for (auto &_child : __children) {
+            auto _ts{Tipset::load(*ipld, _child.cids())};
+            if (!_ts) {
+              spdlog::error("TsSync: tipset {} not loaded: {}",
+                            _child.toPrettyString(),
+                            _ts.error().message());
+              abandon(_child);
+              continue;
+            }
+            auto &child{_ts.value()};
+            boost::optional<bool> child_valid{
+                child->getParentStateRoot() == vm.state_root
+                && child->getParentMessageReceipts() == vm.message_receipts
+                && child->getParentWeight() == weight};
+            if (*child_valid) {
+              auto _signatures{checkSignatures(ipld, *child)};
+              if (_signatures) {
+                child_valid = _signatures.value();
+              } else {
+                spdlog::error("TsSync: signatures of {} not verified: {}",
+                              _child.toPrettyString(),
+                              _signatures.error().message());
+                child_valid = boost::none;
               }
             }
-            valid.emplace(_child, child_valid);
+            if (child_valid && *child_valid && parallel) {
+              validateBranch(std::move(child));
+              continue;
+            }
+            if (child_valid && *child_valid) {
+              child_valid = execute(child);
+            }
+            if (!child_valid) {
+              abandon(_child);
+              continue;
+            }
+            setValid(_child, *child_valid, child->height());
+            queue.push_back(_child);
           }
         } else {
           for (auto &child : _children->second) {
-            valid.emplace(child, false);
+            setValid(child, false, 0);
+            queue.push_back(child);
           }
+          children.erase(_children);
+        }
+      }
+    }
+  }
+
+  void TsSync::validateBranch(std::shared_ptr<const Tipset> child) {
+    branches.insert(child->key);
+    boost::asio::post(
+        *branch_pool, [self{shared_from_this()}, MOVE(child)]() mutable {
+          auto valid{self->execute(child)};
+          // pool thread must not release last reference and join itself
+          auto io{self->io};
+          io->post([MOVE(self), MOVE(child), valid] {
+            self->branches.erase(child->key);
+            if (!valid) {
+              return self->abandon(child->key);
+            }
+            self->setValid(child->key, *valid, child->height());
+            self->walkUp(child->key);
+          });
+        });
+  }
+
+  boost::optional<bool> TsSync::execute(
+      const std::shared_ptr<const Tipset> &ts) const {
+    auto _vm{interpreter->interpret(ipld, ts)};
+    if (!_vm) {
+      if (isConsensusFailure(_vm.error())) {
+        return false;
+      }
+      spdlog::error("TsSync: tipset {} not executed: {}",
+                    ts->key.toPrettyString(),
+                    _vm.error().message());
+      return boost::none;
+    }
+    auto _weight{weight_calculator->calculateWeight(*ts)};
+    if (!_weight) {
+      spdlog::error("TsSync: weight of {} not calculated: {}",
+                    ts->key.toPrettyString(),
+                    _weight.error().message());
+      return boost::none;
+    }
+    return true;
+  }
+
+  void TsSync::abandon(const TipsetKey &key) {
+    std::vector<TipsetKey> queue{key};
+    while (!queue.empty()) {
+      auto _key{std::move(queue.back())};
+      queue.pop_back();
+      auto _callbacks{callbacks.find(_key)};
+      if (_callbacks != callbacks.end()) {
+        auto __callbacks{std::move(_callbacks->second)};
+        callbacks.erase(_callbacks);
+        for (auto &callback : __callbacks) {
+          callback(_key, false);
         }
+      }
+      auto _children{children.find(_key)};
+      if (_children != children.end()) {
         for (auto &child : _children->second) {
           queue.push_back(std::move(child));
         }
@@ -123,11 +414,216 @@ namespace fc::sync {
     }
   }
 
+  bool TsSync::replayChain(const TipsetKey &key,
+                           const BigInt &weight,
+                           const vm::interpreter::Result &vm,
+                           std::vector<TipsetKey> &queue) {
+    auto cached{std::dynamic_pointer_cast<CachedInterpreter>(interpreter)};
+    if (!cached) {
+      return false;
+    }
+    std::vector<TipsetKey> chain;
+    auto _children{children.find(key)};
+    while (_children != children.end() && _children->second.size() == 1
+           && chain.size() < kMaxReplay) {
+      chain.push_back(_children->second[0]);
+      _children = children.find(chain.back());
+    }
+    if (chain.size() < 2) {
+      return false;
+    }
+    std::vector<TipsetCPtr> segment;
+    for (auto &child : chain) {
+      auto ts{Tipset::load(*ipld, child.cids())};
+      if (!ts) {
+        return false;
+      }
+      segment.push_back(std::move(ts.value()));
+    }
+    if (segment[0]->getParentStateRoot() != vm.state_root
+        || segment[0]->getParentMessageReceipts() != vm.message_receipts) {
+      return false;
+    }
+    // weight of tipset is checked by child, last tipset is checked by its
+    // children after replay
+    auto parent_weight{weight};
+    // replayed weights are saved, so they are not calculated again
+    auto weights{
+        std::dynamic_pointer_cast<CachedWeightCalculator>(weight_calculator)};
+    // replay also stops on local failures, which don't invalidate tipset
+    auto rejected{false};
+    auto replay{cached->replay(
+        ipld,
+        segment,
+        vm::interpreter::InterpreterImpl::kDefaultReplayFlush,
+        [&](auto &store, auto i, auto &) -> outcome::result<bool> {
+          auto &ts{*segment[i]};
+          if (ts.getParentWeight() != parent_weight) {
+            rejected = true;
+            return false;
+          }
+          auto _signatures{checkSignatures(store, ts)};
+          if (!_signatures) {
+            return false;
+          }
+          if (!_signatures.value()) {
+            rejected = true;
+            return false;
+          }
+          blockchain::weight::WeightCalculatorImpl weighter{store};
+          auto _weight{weighter.calculateWeight(ts)};
+          if (!_weight) {
+            return false;
+          }
+          if (weights) {
+            OUTCOME_TRY(weights->setWeight(ts.key, _weight.value()));
+          }
+          parent_weight = std::move(_weight.value());
+          return true;
+        })};
+    if (!replay) {
+      return false;
+    }
+    auto &applied{replay.value().results};
+    spdlog::info("TsSync: replayed {} of {} tipsets, {:.1f} tipsets/sec",
+                 applied.size(),
+                 chain.size(),
+                 replay.value().tipsetsPerSecond());
+    children.erase(key);
+    for (auto i{0u}; i < applied.size(); ++i) {
+      setValid(chain[i], true, segment[i]->height());
+      if (i + 1 < chain.size()) {
+        children.erase(chain[i]);
+      }
+      queue.push_back(chain[i]);
+    }
+    auto stop{applied.size()};
+    if (stop < chain.size()) {
+      rejected = rejected || isConsensusFailure(replay.value().error);
+      if (!rejected && stop != 0) {
+        auto &previous{applied.back()};
+        rejected = segment[stop]->getParentStateRoot() != previous.state_root
+                   || segment[stop]->getParentMessageReceipts()
+                          != previous.message_receipts;
+      }
+      if (!rejected) {
+        spdlog::warn("TsSync: replay stopped at {}, not validated",
+                     chain[stop].toPrettyString());
+        abandon(chain[stop]);
+        return true;
+      }
+      // descendants of rejected tipset are invalid too
+      for (auto i{stop}; i < chain.size(); ++i) {
+        setValid(chain[i], false, segment[i]->height());
+        if (i + 1 < chain.size()) {
+          children.erase(chain[i]);
+        }
+        queue.push_back(chain[i]);
+      }
+    }
+    return true;
+  }
+
+  outcome::result<bool> TsSync::checkBlsAggregates(const IpldPtr &store,
+                                                   const Tipset &ts) const {
+    if (!bls_verifier) {
+      return true;
+    }
+    OUTCOME_TRY(results, bls_verifier->verify(store, ts.blks));
+    for (auto &result : results) {
+      if (!result.valid) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  outcome::result<bool> TsSync::checkSecpSignatures(const IpldPtr &store,
+                                                    const Tipset &ts) const {
+    if (!verifier) {
+      return true;
+    }
+    std::vector<SignatureVerifier::Item> items;
+    for (auto &block : ts.blks) {
+      OUTCOME_TRY(meta, store->getCbor<MsgMeta>(block.messages));
+      auto resolve{vm::runtime::keyResolver(store, block.parent_state_root)};
+      auto unresolved{false};
+      OUTCOME_TRY(meta.secp_messages.visit(
+          [&](auto, auto &cid) -> outcome::result<void> {
+            OUTCOME_TRY(message, store->getCbor<SignedMessage>(cid));
+            OUTCOME_TRY(item, SignatureVerifier::item(message, resolve));
+            if (item) {
+              items.push_back(std::move(*item));
+              return outcome::success();
+            }
+            // sender must be account, unless parent state is not stored
+            auto _actor{StateTreeImpl{store, block.parent_state_root}.get(
+                message.message.from)};
+            if (!_actor
+                && _actor.error()
+                       == storage::ipfs::IpfsDatastoreError::kNotFound) {
+              return _actor.error();
+            }
+            unresolved = true;
+            return outcome::success();
+          }));
+      if (unresolved) {
+        return false;
+      }
+    }
+    auto valid{verifier->verify(items)};
+    return std::find(valid.begin(), valid.end(), false) == valid.end();
+  }
+
+  outcome::result<bool> TsSync::checkSignatures(const IpldPtr &store,
+                                                const Tipset &ts) const {
+    OUTCOME_TRY(bls, checkBlsAggregates(store, ts));
+    if (!bls) {
+      return false;
+    }
+    return checkSecpSignatures(store, ts);
+  }
+
+  boost::optional<bool> TsSync::isValid(const TipsetKey &key) const {
+    auto _valid{valid->get(key)};
+    if (!_valid) {
+      spdlog::error("TsSync: validity of {} not loaded: {}",
+                    key.toPrettyString(),
+                    _valid.error().message());
+      return boost::none;
+    }
+    return _valid.value();
+  }
+
+  void TsSync::setValid(const TipsetKey &key, bool _valid, uint64_t height) {
+    if (isValid(key)) {
+      return;
+    }
+    auto _set{valid->set(key, _valid, height)};
+    if (!_set) {
+      spdlog::error("TsSync: validity of {} not saved: {}",
+                    key.toPrettyString(),
+                    _set.error().message());
+    }
+  }
+
   Sync::Sync(IpldPtr ipld,
              std::shared_ptr<TsSync> ts_sync,
              std::shared_ptr<ChainStore> chain_store)
       : MOVE(ipld), MOVE(ts_sync), MOVE(chain_store) {
-    this->ts_sync->valid.emplace(TipsetKey{{this->chain_store->genesisCID()}}, true);
+    this->ts_sync->setValid(
+        TipsetKey{{this->chain_store->genesisCID()}}, true, 0);
+    // validated chain is not validated again after restart
+    if (auto highest{this->ts_sync->valid->highest()}) {
+      auto _ts{Tipset::load(*this->ipld, highest->tipset)};
+      if (_ts) {
+        spdlog::info("Sync: resuming from valid tipset at height {}",
+                     highest->height);
+        for (auto &block : _ts.value()->blks) {
+          std::ignore = this->chain_store->addBlock(block);
+        }
+      }
+    }
   }
 
   void Sync::onHello(const TipsetKey &key, const PeerId &peer) {
@@ -166,6 +662,29 @@ namespace fc::sync {
         if (messages_cid != block.header.messages) {
           return blocksync::Error::kInconsistent;
         }
+        if (ts_sync->verifier) {
+          // results are cached, walkUp will not verify them again, senders
+          // not resolved yet are verified by walkUp
+          auto resolve{vm::runtime::keyResolver(
+              ipld, block.header.parent_state_root)};
+          std::vector<SignatureVerifier::Item> items;
+          for (auto &cid : block.secp_messages) {
+            OUTCOME_TRY(message, ipld->getCbor<SignedMessage>(cid));
+            OUTCOME_TRY(item, SignatureVerifier::item(message, resolve));
+            if (item) {
+              items.push_back(std::move(*item));
+            }
+          }
+          for (auto valid : ts_sync->verifier->verify(items)) {
+            if (!valid) {
+              // messages match block, so block is invalid
+              OUTCOME_TRY(cid, ts_sync->ipld->setCbor(block.header));
+              ts_sync->setValid(
+                  TipsetKey{{cid}}, false, block.header.height);
+              return blocksync::Error::kBadSignature;
+            }
+          }
+        }
       }
     }
     OUTCOME_TRY(cid, ts_sync->ipld->setCbor(block.header));
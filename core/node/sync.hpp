@@ -6,36 +6,178 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <libp2p/peer/peer_id.hpp>
 
 #include "node/fwd.hpp"
+#include "primitives/big_int.hpp"
 #include "primitives/tipset/tipset_key.hpp"
+#include "storage/chain/validity_store.hpp"
+
+namespace fc::blockchain::block_validator {
+  class BlsAggregateVerifier;
+  class HeaderValidator;
+}  // namespace fc::blockchain::block_validator
+
+namespace fc::blockchain::weight {
+  class WeightCalculator;
+}  // namespace fc::blockchain::weight
+
+namespace fc::blocksync {
+  class Fetcher;
+}  // namespace fc::blocksync
 
 namespace fc::sync {
+  using blockchain::block_validator::BlsAggregateVerifier;
+  using blockchain::block_validator::HeaderValidator;
+  using blockchain::weight::WeightCalculator;
   using libp2p::Host;
   using libp2p::peer::PeerId;
+  using primitives::BigInt;
   using primitives::block::BlockWithCids;
+  using primitives::tipset::Tipset;
   using primitives::tipset::TipsetKey;
   using storage::blockchain::ChainStore;
+  using storage::blockchain::ValidityStore;
   using vm::interpreter::Interpreter;
+  using vm::message::SignatureVerifier;
 
   struct TsSync : public std::enable_shared_from_this<TsSync> {
     using Callback = std::function<void(const TipsetKey &, bool)>;
 
+    /// Max number of tipsets replayed at once by walkUp
+    static constexpr size_t kMaxReplay{1000};
+    /// Max number of tipsets in one messages request of walkDown
+    static constexpr size_t kMessagesDepth{32};
+    /// Max number of concurrent walkDown, further sync requests are dropped
+    /// and their callbacks get false
+    static constexpr size_t kMaxWalks{64};
+    /// Default max number of sibling branches validated in parallel, one
+    /// validates them serially on io thread
+    static constexpr size_t kDefaultMaxBranches{1};
+
+    /**
+     * State of walkDown, stages are: fetch headers back to known tipset, check
+     * headers in parallel, fetch messages in batches, execute in walkUp.
+     * Chain with bad headers is rejected before messages are fetched.
+     */
+    struct Walk {
+      TipsetKey top;
+      PeerId peer;
+      /// Next tipset to fetch headers of
+      TipsetKey key;
+      /// Tipsets from descendant to known ancestor, which is last
+      std::vector<std::shared_ptr<const Tipset>> chain{};
+      /// Number of messages requests in flight
+      size_t pending{};
+      bool dispatched{false};
+      bool failed{false};
+    };
+
     TsSync(std::shared_ptr<Host> host,
            IpldPtr ipld,
-           std::shared_ptr<Interpreter> interpreter);
+           std::shared_ptr<Interpreter> interpreter,
+           std::shared_ptr<SignatureVerifier> verifier,
+           std::shared_ptr<HeaderValidator> header_validator,
+           std::shared_ptr<BlsAggregateVerifier> bls_verifier,
+           std::shared_ptr<ValidityStore> valid,
+           std::shared_ptr<WeightCalculator> weight_calculator,
+           std::shared_ptr<boost::asio::io_context> io,
+           size_t max_branches = kDefaultMaxBranches);
+    /**
+     * Validates tipset, fetching it and ancestors from peer if needed.
+     * Callback gets false without persisting validity, if sync is dropped
+     * by kMaxWalks or fails locally, so next sync of tipset retries.
+     */
     void sync(const TipsetKey &key, const PeerId &peer, Callback callback);
+    /// Fetches missing headers and messages of tipset and ancestors down to
+    /// known tipset, then links them and calls walkUp
     void walkDown(TipsetKey key, const PeerId &peer);
+    void walkHeaders(std::shared_ptr<Walk> walk);
+    /// Marks chain invalid from first tipset with bad headers
+    /// @return false if chain was rejected
+    bool checkHeaders(const std::shared_ptr<Walk> &walk);
+    void fetchMessages(const std::shared_ptr<Walk> &walk);
+    void finishWalk(const std::shared_ptr<Walk> &walk);
+    /// Drops walk and calls callbacks of its tipset with false, validity is
+    /// not persisted, so next sync retries it
+    void failWalk(const std::shared_ptr<Walk> &walk);
     void walkUp(TipsetKey key);
+    /**
+     * Forgets tipset and its descendants, which can't be validated due to
+     * local failure. Their validity is not persisted, callbacks get false and
+     * next sync validates them again.
+     */
+    void abandon(const TipsetKey &key);
+    /**
+     * Executes tipset and calculates its weight
+     * @return false if tipset is rejected by consensus rules, none if it
+     * failed locally and was not validated
+     */
+    boost::optional<bool> execute(
+        const std::shared_ptr<const Tipset> &ts) const;
+    /**
+     * Executes child of fork on branch pool, then marks its validity and
+     * continues walkUp from it on io thread.
+     * Sibling branches don't wait for each other.
+     */
+    void validateBranch(std::shared_ptr<const Tipset> child);
+    /**
+     * Validates linear chain of descendants of valid tipset with one state
+     * tree, if interpreter supports replay.
+     * Marks validity of chain, adds chain tail to queue. Tipset at which
+     * replay stopped without consensus reason is abandoned.
+     * @return false if chain was not replayed
+     */
+    bool replayChain(const TipsetKey &key,
+                     const BigInt &weight,
+                     const vm::interpreter::Result &vm,
+                     std::vector<TipsetKey> &queue);
+    /**
+     * Verifies BLS aggregates of tipset blocks in parallel
+     * @param store - contains parent state of tipset
+     * @return false if aggregate of some block is invalid
+     */
+    outcome::result<bool> checkBlsAggregates(const IpldPtr &store,
+                                             const Tipset &ts) const;
+    /**
+     * Verifies secp message signatures of tipset blocks, senders are
+     * resolved in parent state. Signatures verified when messages were
+     * received are taken from verifier cache.
+     * @param store - contains parent state of tipset
+     * @return false if some signature is invalid or sender is not account
+     */
+    outcome::result<bool> checkSecpSignatures(const IpldPtr &store,
+                                              const Tipset &ts) const;
+    /// Checks BLS aggregates, then secp signatures
+    outcome::result<bool> checkSignatures(const IpldPtr &store,
+                                          const Tipset &ts) const;
+    /// Returns validity of tipset, none if it was not validated yet
+    boost::optional<bool> isValid(const TipsetKey &key) const;
+    /// Persists validity of tipset, known validity is not changed
+    void setValid(const TipsetKey &key, bool valid, uint64_t height);
 
     std::shared_ptr<Host> host;
     IpldPtr ipld;
     std::shared_ptr<Interpreter> interpreter;
+    std::shared_ptr<SignatureVerifier> verifier;
+    std::shared_ptr<HeaderValidator> header_validator;
+    std::shared_ptr<BlsAggregateVerifier> bls_verifier;
+    std::shared_ptr<blocksync::Fetcher> fetcher;
     std::unordered_map<TipsetKey, std::vector<Callback>> callbacks;
     std::unordered_map<TipsetKey, std::vector<TipsetKey>> children;
-
-    // TODO: component, persistent/caching
-    std::unordered_map<TipsetKey, bool> valid;
+    std::shared_ptr<ValidityStore> valid;
+    std::shared_ptr<WeightCalculator> weight_calculator;
+    /// Number of walkDown in progress
+    size_t walks{};
+    std::shared_ptr<boost::asio::io_context> io;
+    /// Thread pool limiting parallel branches, null if validated serially
+    std::unique_ptr<boost::asio::thread_pool> branch_pool;
+    /// Children of forks being validated on branch pool
+    std::unordered_set<TipsetKey> branches;
   };
 
   struct Sync : public std::enable_shared_from_this<Sync> {
@@ -9,6 +9,7 @@
 #include <libp2p/multi/uvarint.hpp>
 #include "codec/uvarint.hpp"
 #include "crypto/blake2/blake2b160.hpp"
+#include "crypto/hasher/multi_buffer.hpp"
 
 using libp2p::multi::HashType;
 using libp2p::multi::Multihash;
@@ -147,4 +148,17 @@ namespace fc::common {
     OUTCOME_TRY(hash, Multihash::create(HashType::blake2b_256, hash_raw));
     return CID(CID::Version::V1, CID::Multicodec::DAG_CBOR, hash);
   }
+
+  outcome::result<std::vector<CID>> getCidsOf(
+      gsl::span<const gsl::span<const uint8_t>> inputs) {
+    std::vector<Hash256> hashes_raw(inputs.size());
+    crypto::multi_buffer::blake2b_256(inputs, hashes_raw);
+    std::vector<CID> cids;
+    cids.reserve(inputs.size());
+    for (auto &hash_raw : hashes_raw) {
+      OUTCOME_TRY(hash, Multihash::create(HashType::blake2b_256, hash_raw));
+      cids.emplace_back(CID::Version::V1, CID::Multicodec::DAG_CBOR, hash);
+    }
+    return std::move(cids);
+  }
 }  // namespace fc::common
@@ -99,6 +99,10 @@ namespace fc::common {
   /// Compute CID from bytes
   outcome::result<CID> getCidOf(gsl::span<const uint8_t> bytes);
 
+  /// Compute CIDs of independent byte arrays with batch hashing
+  outcome::result<std::vector<CID>> getCidsOf(
+      gsl::span<const gsl::span<const uint8_t>> inputs);
+
 }  // namespace fc::common
 
 #endif  // CPP_FILECOIN_CORE_COMMON_CID_HPP
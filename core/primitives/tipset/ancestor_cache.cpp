@@ -0,0 +1,116 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/tipset/ancestor_cache.hpp"
+
+namespace fc::primitives::tipset {
+  AncestorCache::AncestorCache(size_t size) : cache_{size} {}
+
+  outcome::result<TipsetCPtr> AncestorCache::parent(Ipld &ipld,
+                                                    const Tipset &tipset) {
+    OUTCOME_TRY(parent, node(ipld, tipset.getParents()));
+    return parent->tipset;
+  }
+
+  outcome::result<TipsetCPtr> AncestorCache::ancestor(Ipld &ipld,
+                                                      const TipsetCPtr &tipset,
+                                                      ChainEpoch height) {
+    auto current{node(tipset)};
+    while (static_cast<ChainEpoch>(current->tipset->height()) > height) {
+      OUTCOME_TRY(next, skip(ipld, current, 0));
+      if (!next) {
+        break;
+      }
+      // farthest skip still above height
+      for (size_t k{1}; static_cast<ChainEpoch>(next->height) > height; ++k) {
+        OUTCOME_TRY(further, skip(ipld, current, k));
+        if (!further || static_cast<ChainEpoch>(further->height) <= height) {
+          break;
+        }
+        next = std::move(further);
+      }
+      OUTCOME_TRYA(current, node(ipld, next->key));
+    }
+    return current->tipset;
+  }
+
+  AncestorCache::Stats AncestorCache::stats() const {
+    std::lock_guard lock{mutex_};
+    return {cache_.hits(), cache_.misses(), loads_};
+  }
+
+  void AncestorCache::clear() {
+    std::lock_guard lock{mutex_};
+    cache_.clear();
+  }
+
+  outcome::result<AncestorCache::NodePtr> AncestorCache::node(
+      Ipld &ipld, const TipsetKey &key) {
+    common::Buffer hash{key.hash()};
+    {
+      std::lock_guard lock{mutex_};
+      if (auto node{cache_.get(hash)}) {
+        return *node;
+      }
+    }
+    OUTCOME_TRY(tipset, Tipset::load(ipld, key.cids()));
+    auto node{std::make_shared<Node>(Node{std::move(tipset), {}})};
+    std::lock_guard lock{mutex_};
+    ++loads_;
+    cache_.put(hash, node);
+    return node;
+  }
+
+  AncestorCache::NodePtr AncestorCache::node(const TipsetCPtr &tipset) {
+    common::Buffer hash{tipset->key.hash()};
+    std::lock_guard lock{mutex_};
+    if (auto node{cache_.get(hash)}) {
+      return *node;
+    }
+    auto node{std::make_shared<Node>(Node{tipset, {}})};
+    cache_.put(hash, node);
+    return node;
+  }
+
+  outcome::result<boost::optional<AncestorCache::Skip>> AncestorCache::skip(
+      Ipld &ipld, const NodePtr &node, size_t k) {
+    {
+      std::lock_guard lock{mutex_};
+      if (k < node->skips.size()) {
+        return node->skips[k];
+      }
+    }
+    if (node->tipset->height() == 0) {
+      return boost::none;
+    }
+    boost::optional<Skip> skip;
+    if (k == 0) {
+      OUTCOME_TRY(parent, this->node(ipld, node->tipset->getParents()));
+      skip = Skip{parent->tipset->key, parent->tipset->height()};
+    } else {
+      // 2^k = 2^(k-1) + 2^(k-1)
+      OUTCOME_TRY(half, this->skip(ipld, node, k - 1));
+      if (!half) {
+        return boost::none;
+      }
+      OUTCOME_TRY(middle, this->node(ipld, half->key));
+      OUTCOME_TRYA(skip, this->skip(ipld, middle, k - 1));
+      if (!skip) {
+        return boost::none;
+      }
+    }
+    std::lock_guard lock{mutex_};
+    // skips are appended in order, concurrent builders compute same values
+    if (node->skips.size() == k) {
+      node->skips.push_back(*skip);
+    }
+    return skip;
+  }
+
+  AncestorCache &ancestorCache() {
+    static AncestorCache cache;
+    return cache;
+  }
+}  // namespace fc::primitives::tipset
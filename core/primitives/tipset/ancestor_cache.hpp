@@ -0,0 +1,78 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PRIMITIVES_TIPSET_ANCESTOR_CACHE_HPP
+#define CPP_FILECOIN_CORE_PRIMITIVES_TIPSET_ANCESTOR_CACHE_HPP
+
+#include <mutex>
+
+#include "common/lru_cache.hpp"
+#include "primitives/tipset/tipset.hpp"
+
+namespace fc::primitives::tipset {
+  /**
+   * Cache of decoded tipsets with skip list of ancestors.
+   * Skip k of tipset points to ancestor 2^k tipsets below, so ancestor at
+   * height is found in O(log n) lookups. Skips are built lazily.
+   * Tipsets are content addressed, so cache may be shared between stores.
+   */
+  class AncestorCache {
+   public:
+    /// Default number of cached tipsets
+    static constexpr size_t kDefaultSize{4096};
+
+    struct Stats {
+      size_t hits, misses, loads;
+    };
+
+    explicit AncestorCache(size_t size = kDefaultSize);
+
+    /// Returns parent of tipset
+    outcome::result<TipsetCPtr> parent(Ipld &ipld, const Tipset &tipset);
+
+    /**
+     * Returns highest ancestor of tipset with height not above given, or
+     * genesis. Returns tipset itself if its height is not above.
+     */
+    outcome::result<TipsetCPtr> ancestor(Ipld &ipld,
+                                         const TipsetCPtr &tipset,
+                                         ChainEpoch height);
+
+    Stats stats() const;
+
+    void clear();
+
+   private:
+    struct Skip {
+      TipsetKey key;
+      uint64_t height;
+    };
+
+    struct Node {
+      TipsetCPtr tipset;
+      /// Built skips, guarded by cache mutex
+      std::vector<Skip> skips;
+    };
+    using NodePtr = std::shared_ptr<Node>;
+
+    outcome::result<NodePtr> node(Ipld &ipld, const TipsetKey &key);
+
+    NodePtr node(const TipsetCPtr &tipset);
+
+    /// Returns skip k of node, none for genesis
+    outcome::result<boost::optional<Skip>> skip(Ipld &ipld,
+                                                const NodePtr &node,
+                                                size_t k);
+
+    mutable std::mutex mutex_;
+    common::LruCache<common::Buffer, NodePtr> cache_;
+    size_t loads_{};
+  };
+
+  /// Cache used by tipset randomness and beacon lookups
+  AncestorCache &ancestorCache();
+}  // namespace fc::primitives::tipset
+
+#endif  // CPP_FILECOIN_CORE_PRIMITIVES_TIPSET_ANCESTOR_CACHE_HPP
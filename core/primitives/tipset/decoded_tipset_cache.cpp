@@ -0,0 +1,41 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/tipset/decoded_tipset_cache.hpp"
+
+namespace fc::primitives::tipset {
+  DecodedTipsetCache::DecodedTipsetCache(size_t bytes)
+      : cache_{bytes, [](auto &entry) { return entry.second; }} {}
+
+  TipsetCPtr DecodedTipsetCache::get(const TipsetHash &hash) {
+    std::lock_guard lock{mutex_};
+    if (auto entry{cache_.get(common::Buffer{hash})}) {
+      return entry->first;
+    }
+    return nullptr;
+  }
+
+  void DecodedTipsetCache::put(const TipsetHash &hash,
+                               TipsetCPtr tipset,
+                               size_t bytes) {
+    std::lock_guard lock{mutex_};
+    cache_.put(common::Buffer{hash}, {std::move(tipset), bytes});
+  }
+
+  DecodedTipsetCache::Stats DecodedTipsetCache::stats() const {
+    std::lock_guard lock{mutex_};
+    return {cache_.hits(), cache_.misses(), cache_.size(), cache_.weight()};
+  }
+
+  void DecodedTipsetCache::clear() {
+    std::lock_guard lock{mutex_};
+    cache_.clear();
+  }
+
+  DecodedTipsetCache &decodedTipsetCache() {
+    static DecodedTipsetCache cache;
+    return cache;
+  }
+}  // namespace fc::primitives::tipset
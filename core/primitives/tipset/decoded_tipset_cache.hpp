@@ -0,0 +1,50 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PRIMITIVES_TIPSET_DECODED_TIPSET_CACHE_HPP
+#define CPP_FILECOIN_CORE_PRIMITIVES_TIPSET_DECODED_TIPSET_CACHE_HPP
+
+#include <mutex>
+
+#include "common/lru_cache.hpp"
+#include "primitives/tipset/tipset.hpp"
+
+namespace fc::primitives::tipset {
+  /**
+   * Cache of decoded tipsets by key, limited by size of encoded headers.
+   * Tipsets are immutable and content addressed, so entries are only
+   * evicted, never invalidated.
+   */
+  class DecodedTipsetCache {
+   public:
+    /// Default limit of encoded header bytes
+    static constexpr size_t kDefaultBytes{64 << 20};
+
+    struct Stats {
+      size_t hits, misses, size, bytes;
+    };
+
+    explicit DecodedTipsetCache(size_t bytes = kDefaultBytes);
+
+    /// Returns cached tipset, null if not cached
+    TipsetCPtr get(const TipsetHash &hash);
+
+    /// @param bytes - size of encoded headers
+    void put(const TipsetHash &hash, TipsetCPtr tipset, size_t bytes);
+
+    Stats stats() const;
+
+    void clear();
+
+   private:
+    mutable std::mutex mutex_;
+    common::LruCache<common::Buffer, std::pair<TipsetCPtr, size_t>> cache_;
+  };
+
+  /// Cache used by Tipset::load
+  DecodedTipsetCache &decodedTipsetCache();
+}  // namespace fc::primitives::tipset
+
+#endif  // CPP_FILECOIN_CORE_PRIMITIVES_TIPSET_DECODED_TIPSET_CACHE_HPP
@@ -10,6 +10,8 @@
 #include "crypto/blake2/blake2b160.hpp"
 #include "primitives/address/address_codec.hpp"
 #include "primitives/cid/cid_of_cbor.hpp"
+#include "primitives/tipset/ancestor_cache.hpp"
+#include "primitives/tipset/decoded_tipset_cache.hpp"
 #include "vm/message/message.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::primitives::tipset, TipsetError, e) {
@@ -217,13 +219,34 @@ namespace fc::primitives::tipset {
 
   outcome::result<TipsetCPtr> Tipset::load(Ipld &ipld,
                                            const std::vector<CID> &cids) {
+    auto &cache{decodedTipsetCache()};
+    auto hash{TipsetKey::hash(cids)};
+    if (auto tipset{cache.get(hash)}) {
+      // cache is shared by stores, load also means headers are in this one
+      auto stored{true};
+      for (auto &cid : cids) {
+        OUTCOME_TRY(has, ipld.contains(cid));
+        if (!has) {
+          stored = false;
+          break;
+        }
+      }
+      if (stored) {
+        return tipset;
+      }
+    }
     std::vector<BlockHeader> blocks;
     blocks.reserve(cids.size());
+    size_t bytes{0};
     for (auto &cid : cids) {
-      OUTCOME_TRY(block, ipld.getCbor<BlockHeader>(cid));
+      OUTCOME_TRY(raw, ipld.get(cid));
+      bytes += raw.size();
+      OUTCOME_TRY(block, codec::cbor::decode<BlockHeader>(raw));
       blocks.emplace_back(std::move(block));
     }
-    return create(std::move(blocks));
+    OUTCOME_TRY(tipset, create(std::move(blocks)));
+    cache.put(hash, tipset, bytes);
+    return std::move(tipset);
   }
 
   outcome::result<TipsetCPtr> Tipset::loadParent(Ipld &ipld) const {
@@ -244,7 +267,7 @@ namespace fc::primitives::tipset {
       if (ts->height() == 0) {
         break;
       }
-      OUTCOME_TRYA(parent, ts->loadParent(ipld));
+      OUTCOME_TRYA(parent, ancestorCache().parent(ipld, *ts));
       ts = parent.get();
     }
     return TipsetError::kNoBeacons;
@@ -292,10 +315,12 @@ namespace fc::primitives::tipset {
       ChainEpoch round,
       gsl::span<const uint8_t> entropy) const {
     auto ts{this};
-    TipsetCPtr parent;
-    while (ts->height() != 0 && static_cast<ChainEpoch>(ts->height()) > round) {
-      OUTCOME_TRYA(parent, ts->loadParent(ipld));
-      ts = parent.get();
+    TipsetCPtr ancestor;
+    if (ts->height() != 0 && static_cast<ChainEpoch>(ts->height()) > round) {
+      auto &cache{ancestorCache()};
+      OUTCOME_TRY(parent, cache.parent(ipld, *this));
+      OUTCOME_TRYA(ancestor, cache.ancestor(ipld, parent, round));
+      ts = ancestor.get();
     }
     OUTCOME_TRY(beacon, ts->latestBeacon(ipld));
     return crypto::randomness::drawRandomness(beacon.data, tag, round, entropy);
@@ -307,10 +332,12 @@ namespace fc::primitives::tipset {
       ChainEpoch round,
       gsl::span<const uint8_t> entropy) const {
     auto ts{this};
-    TipsetCPtr parent;
-    while (ts->height() != 0 && static_cast<ChainEpoch>(ts->height()) > round) {
-      OUTCOME_TRYA(parent, ts->loadParent(ipld));
-      ts = parent.get();
+    TipsetCPtr ancestor;
+    if (ts->height() != 0 && static_cast<ChainEpoch>(ts->height()) > round) {
+      auto &cache{ancestorCache()};
+      OUTCOME_TRY(parent, cache.parent(ipld, *this));
+      OUTCOME_TRYA(ancestor, cache.ancestor(ipld, parent, round));
+      ts = ancestor.get();
     }
     return crypto::randomness::drawRandomness(
         ts->getMinTicketBlock().ticket->bytes, tag, round, entropy);
@@ -127,7 +127,7 @@ namespace fc::storage::amt {
   outcome::result<CID> Amt::flush() {
     if (which<Root>(root_)) {
       auto &root = boost::get<Root>(root_);
-      OUTCOME_TRY(flush(root.node));
+      OUTCOME_TRY(flush({&root.node}));
       OUTCOME_TRY(root_cid, ipld->setCbor(root));
       root_ = root_cid;
     }
@@ -195,18 +195,28 @@ namespace fc::storage::amt {
     return res.error();
   }
 
-  outcome::result<void> Amt::flush(Node &node) {
-    if (which<Node::Links>(node.items)) {
-      auto &links = boost::get<Node::Links>(node.items);
-      for (auto &pair : links) {
-        if (which<Node::Ptr>(pair.second)) {
-          auto &child = *boost::get<Node::Ptr>(pair.second);
-          OUTCOME_TRY(flush(child));
-          OUTCOME_TRY(cid, ipld->setCbor(child));
-          pair.second = cid;
+  outcome::result<void> Amt::flush(const std::vector<Node *> &nodes) {
+    std::vector<Node::Link *> dirty;
+    std::vector<Node *> children;
+    for (auto node : nodes) {
+      if (which<Node::Links>(node->items)) {
+        auto &links = boost::get<Node::Links>(node->items);
+        for (auto &pair : links) {
+          if (which<Node::Ptr>(pair.second)) {
+            dirty.push_back(&pair.second);
+            children.push_back(boost::get<Node::Ptr>(pair.second).get());
+          }
         }
       }
     }
+    if (children.empty()) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(flush(children));
+    OUTCOME_TRY(cids, ipld->setCborBatch(children));
+    for (auto i{0u}; i < dirty.size(); ++i) {
+      *dirty[i] = std::move(cids[i]);
+    }
     return outcome::success();
   }
 
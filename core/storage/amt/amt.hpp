@@ -167,7 +167,8 @@ namespace fc::storage::amt {
                               uint64_t key,
                               gsl::span<const uint8_t> value);
     outcome::result<bool> remove(Node &node, uint64_t height, uint64_t key);
-    outcome::result<void> flush(Node &node);
+    /// Flush dirty children, nodes of same depth are hashed in one batch
+    outcome::result<void> flush(const std::vector<Node *> &nodes);
     outcome::result<void> visit(Node &node,
                                 uint64_t height,
                                 uint64_t offset,
@@ -0,0 +1,119 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/height_index.hpp"
+
+#include "codec/cbor/cbor.hpp"
+#include "common/logger.hpp"
+
+namespace fc::storage::blockchain {
+  using primitives::tipset::Tipset;
+
+  namespace {
+    const Buffer kHeadKey{Buffer{}.put("height:head")};
+
+    Buffer heightKey(uint64_t height) {
+      return Buffer{}.put("height:").putUint64(height);
+    }
+  }  // namespace
+
+  HeightIndex::HeightIndex(IpldPtr ipld,
+                           std::shared_ptr<PersistentBufferMap> store)
+      : ipld{std::move(ipld)}, store{std::move(store)} {}
+
+  outcome::result<std::shared_ptr<HeightIndex>> HeightIndex::create(
+      IpldPtr ipld,
+      std::shared_ptr<PersistentBufferMap> store,
+      std::shared_ptr<ChainStore> chain_store) {
+    auto index{std::make_shared<HeightIndex>(ipld, store)};
+    if (store->contains(kHeadKey)) {
+      OUTCOME_TRY(raw, store->get(kHeadKey));
+      OUTCOME_TRYA(index->head_height, codec::cbor::decode<uint64_t>(raw));
+    }
+    index->head_sub = chain_store->subscribeHeadChanges([=](auto &change) {
+      auto res{index->onHeadChange(change)};
+      if (!res) {
+        spdlog::error("HeightIndex.onHeadChange: error {} \"{}\"",
+                      res.error(),
+                      res.error().message());
+      }
+    });
+    return index;
+  }
+
+  outcome::result<void> HeightIndex::onHeadChange(const HeadChange &change) {
+    auto &ts{change.value};
+    if (change.type == HeadChangeType::REVERT) {
+      OUTCOME_TRY(key, get(ts->height()));
+      if (key == ts->key) {
+        OUTCOME_TRY(store->remove(heightKey(ts->height())));
+      }
+      return outcome::success();
+    }
+    return setHead(ts);
+  }
+
+  outcome::result<boost::optional<TipsetKey>> HeightIndex::get(
+      uint64_t height) const {
+    auto key{heightKey(height)};
+    if (!store->contains(key)) {
+      return boost::none;
+    }
+    OUTCOME_TRY(raw, store->get(key));
+    OUTCOME_TRY(cids, codec::cbor::decode<std::vector<CID>>(raw));
+    return TipsetKey{std::move(cids)};
+  }
+
+  outcome::result<TipsetCPtr> HeightIndex::lookup(TipsetCPtr tipset,
+                                                  uint64_t height) const {
+    while (tipset->height() > height) {
+      OUTCOME_TRY(key, get(tipset->height()));
+      if (key == tipset->key) {
+        // canonical chain, null rounds are skipped up to tipset
+        for (auto h{height}; h < tipset->height(); ++h) {
+          OUTCOME_TRY(_key, get(h));
+          if (_key) {
+            return Tipset::load(*ipld, _key->cids());
+          }
+        }
+        break;
+      }
+      OUTCOME_TRY(parent, tipset->loadParent(*ipld));
+      if (parent->height() < height) {
+        break;
+      }
+      tipset = std::move(parent);
+    }
+    return std::move(tipset);
+  }
+
+  outcome::result<void> HeightIndex::setHead(TipsetCPtr tipset) {
+    auto batch{store->batch()};
+    for (auto h{tipset->height() + 1}; h <= head_height; ++h) {
+      OUTCOME_TRY(batch->remove(heightKey(h)));
+    }
+    head_height = tipset->height();
+    OUTCOME_TRY(raw_head, codec::cbor::encode(head_height));
+    OUTCOME_TRY(batch->put(kHeadKey, raw_head));
+    // heights below first already indexed tipset are consistent
+    while (true) {
+      OUTCOME_TRY(key, get(tipset->height()));
+      if (key == tipset->key) {
+        break;
+      }
+      OUTCOME_TRY(raw, codec::cbor::encode(tipset->key.cids()));
+      OUTCOME_TRY(batch->put(heightKey(tipset->height()), raw));
+      if (tipset->height() == 0) {
+        break;
+      }
+      OUTCOME_TRY(parent, tipset->loadParent(*ipld));
+      for (auto h{parent->height() + 1}; h < tipset->height(); ++h) {
+        OUTCOME_TRY(batch->remove(heightKey(h)));
+      }
+      tipset = std::move(parent);
+    }
+    return batch->commit();
+  }
+}  // namespace fc::storage::blockchain
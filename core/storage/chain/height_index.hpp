@@ -0,0 +1,48 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_HEIGHT_INDEX_HPP
+#define CPP_FILECOIN_CORE_STORAGE_CHAIN_HEIGHT_INDEX_HPP
+
+#include "storage/buffer_map.hpp"
+#include "storage/chain/chain_store.hpp"
+
+namespace fc::storage::blockchain {
+  /**
+   * Persistent index of canonical chain tipsets by height.
+   * Follows head changes, reorg rewrites heights of reverted branch.
+   * Null rounds have no entries.
+   */
+  struct HeightIndex : public std::enable_shared_from_this<HeightIndex> {
+    HeightIndex(IpldPtr ipld, std::shared_ptr<PersistentBufferMap> store);
+    static outcome::result<std::shared_ptr<HeightIndex>> create(
+        IpldPtr ipld,
+        std::shared_ptr<PersistentBufferMap> store,
+        std::shared_ptr<ChainStore> chain_store);
+    outcome::result<void> onHeadChange(const HeadChange &change);
+
+    /// Returns key of canonical tipset at height, none for null round
+    outcome::result<boost::optional<TipsetKey>> get(uint64_t height) const;
+
+    /**
+     * Finds ancestor of tipset at height, or lowest ancestor above height if
+     * height is null round.
+     * Walks parents only until canonical chain is reached.
+     */
+    outcome::result<TipsetCPtr> lookup(TipsetCPtr tipset,
+                                       uint64_t height) const;
+
+    IpldPtr ipld;
+    std::shared_ptr<PersistentBufferMap> store;
+    ChainStore::connection_t head_sub;
+    /// Height of indexed head
+    uint64_t head_height{};
+
+   private:
+    outcome::result<void> setHead(TipsetCPtr tipset);
+  };
+}  // namespace fc::storage::blockchain
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_CHAIN_HEIGHT_INDEX_HPP
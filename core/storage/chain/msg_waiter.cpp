@@ -10,63 +10,233 @@
 namespace fc::storage::blockchain {
   using primitives::tipset::MessageVisitor;
 
-  MsgWaiter::MsgWaiter(IpldPtr ipld) : ipld{ipld} {}
+  namespace {
+    /// Tipsets from which indexing continues down, if it was interrupted
+    const Buffer kTailsKey{Buffer{}.put("msg_tails")};
+
+    /// Number of tipsets indexed between saves of position
+    constexpr size_t kSaveTailEvery{100};
+
+    Buffer messageKey(const CID &cid) {
+      OUTCOME_EXCEPT(bytes, cid.toBytes());
+      return Buffer{}.put("msg:").put(bytes);
+    }
+
+    /// Marks tipset which parent messages are indexed
+    Buffer tipsetKey(const TipsetCPtr &ts) {
+      return Buffer{}.put("msg_ts:").put(ts->key.hash());
+    }
+
+    void logError(std::string_view where, const std::error_code &error) {
+      spdlog::error(
+          "MsgWaiter.{}: error {} \"{}\"", where, error, error.message());
+    }
+  }  // namespace
+
+  MsgWaiter::MsgWaiter(IpldPtr ipld,
+                       std::shared_ptr<PersistentBufferMap> store)
+      : ipld{std::move(ipld)}, store{std::move(store)} {}
+
+  MsgWaiter::~MsgWaiter() {
+    stop = true;
+    join();
+  }
 
   std::shared_ptr<MsgWaiter> MsgWaiter::create(
-      IpldPtr ipld, std::shared_ptr<ChainStore> chain_store) {
-    auto waiter{std::make_shared<MsgWaiter>(ipld)};
+      IpldPtr ipld,
+      std::shared_ptr<PersistentBufferMap> store,
+      std::shared_ptr<ChainStore> chain_store) {
+    auto waiter{std::make_shared<MsgWaiter>(ipld, store)};
     waiter->head_sub = chain_store->subscribeHeadChanges([=](auto &change) {
       auto res{waiter->onHeadChange(change)};
       if (!res) {
-        spdlog::error("MsgWaiter.onHeadChange: error {} \"{}\"",
-                      res.error(),
-                      res.error().message());
+        logError("onHeadChange", res.error());
       }
     });
     return waiter;
   }
 
   outcome::result<void> MsgWaiter::onHeadChange(const HeadChange &change) {
-    auto onTipset = [&](auto &ts, auto apply) -> outcome::result<TipsetCPtr> {
-      OUTCOME_TRY(parent, ts->loadParent(*ipld));
-      adt::Array<MessageReceipt> receipts{ts->getParentMessageReceipts(), ipld};
-      OUTCOME_TRY(parent->visitMessages(
-          ipld, [&](auto i, auto, auto &cid) -> outcome::result<void> {
-            if (apply) {
-              OUTCOME_TRY(receipt, receipts.get(i));
-              auto result{
-                  results.emplace(cid, std::make_pair(receipt, ts->key))};
-              auto callbacks{waiting.find(cid)};
-              if (callbacks != waiting.end()) {
-                for (auto &callback : callbacks->second) {
-                  callback(result.first->second);
-                }
-                waiting.erase(cid);
-              }
-            } else {
-              results.erase(cid);
-            }
-            return outcome::success();
-          }));
-      return std::move(parent);
-    };
-    if (change.type == HeadChangeType::CURRENT) {
-      auto ts{change.value};
-      while (ts->height() > 0) {
-        OUTCOME_TRYA(ts, onTipset(ts, true));
-      }
-    } else {
-      OUTCOME_TRY(onTipset(change.value, change.type == HeadChangeType::APPLY));
+    auto &ts{change.value};
+    switch (change.type) {
+      case HeadChangeType::CURRENT:
+        stop = true;
+        join();
+        stop = false;
+        reverted.clear();
+        backfill_thread = std::thread{[this, ts] { backfill(ts); }};
+        break;
+      case HeadChangeType::APPLY:
+        OUTCOME_TRY(apply(ts, false));
+        break;
+      case HeadChangeType::REVERT:
+        OUTCOME_TRY(revert(ts));
+        break;
     }
     return outcome::success();
   }
 
+  outcome::result<boost::optional<MsgWaiter::Result>> MsgWaiter::search(
+      const CID &cid) const {
+    auto key{messageKey(cid)};
+    if (!store->contains(key)) {
+      return boost::none;
+    }
+    OUTCOME_TRY(raw, store->get(key));
+    OUTCOME_TRY(inclusion, codec::cbor::decode<Inclusion>(raw));
+    OUTCOME_TRY(ts, primitives::tipset::Tipset::load(*ipld, inclusion.tipset));
+    adt::Array<MessageReceipt> receipts{ts->getParentMessageReceipts(), ipld};
+    OUTCOME_TRY(receipt, receipts.get(inclusion.index));
+    return Result{std::move(receipt), ts->key};
+  }
+
   void MsgWaiter::wait(const CID &cid, const Callback &callback) {
-    auto result{results.find(cid)};
-    if (result != results.end()) {
-      callback(result->second);
+    std::unique_lock lock{mutex};
+    auto result{search(cid)};
+    if (!result) {
+      logError("wait", result.error());
+    } else if (result.value()) {
+      lock.unlock();
+      return callback(*result.value());
+    }
+    waiting[cid].push_back(callback);
+  }
+
+  void MsgWaiter::join() {
+    if (backfill_thread.joinable()) {
+      backfill_thread.join();
+    }
+  }
+
+  outcome::result<bool> MsgWaiter::indexed(const TipsetCPtr &ts) const {
+    return store->contains(tipsetKey(ts));
+  }
+
+  outcome::result<TipsetCPtr> MsgWaiter::apply(const TipsetCPtr &ts,
+                                               bool backfill) {
+    OUTCOME_TRY(parent, ts->loadParent(*ipld));
+    std::unique_lock index_lock{index_mutex};
+    if (backfill) {
+      if (reverted.count(ts->key) != 0) {
+        return std::move(parent);
+      }
     } else {
-      waiting[cid].push_back(callback);
+      reverted.erase(ts->key);
+    }
+    auto batch{store->batch()};
+    std::vector<CID> cids;
+    OUTCOME_TRY(parent->visitMessages(
+        ipld, [&](auto i, auto, auto &cid) -> outcome::result<void> {
+          auto key{messageKey(cid)};
+          auto found{store->contains(key)};
+          if (found) {
+            // earliest inclusion is kept, backfill meets later ones first
+            OUTCOME_TRY(raw, store->get(key));
+            OUTCOME_TRY(inclusion, codec::cbor::decode<Inclusion>(raw));
+            if (inclusion.epoch <= (ChainEpoch)ts->height()) {
+              return outcome::success();
+            }
+          }
+          OUTCOME_TRY(raw,
+                      codec::cbor::encode(Inclusion{
+                          ts->key.cids(), i, (ChainEpoch)ts->height()}));
+          OUTCOME_TRY(batch->put(key, raw));
+          if (!found) {
+            cids.push_back(cid);
+          }
+          return outcome::success();
+        }));
+    OUTCOME_TRY(batch->put(tipsetKey(ts), Buffer{}));
+    std::vector<std::pair<CID, std::vector<Callback>>> ready;
+    {
+      // waiters check index under same lock
+      std::lock_guard lock{mutex};
+      OUTCOME_TRY(batch->commit());
+      for (auto &cid : cids) {
+        auto it{waiting.find(cid)};
+        if (it != waiting.end()) {
+          ready.emplace_back(cid, std::move(it->second));
+          waiting.erase(it);
+        }
+      }
+    }
+    // results are read before revert can remove inclusions
+    std::vector<std::pair<Result, std::vector<Callback>>> results;
+    for (auto &[cid, callbacks] : ready) {
+      OUTCOME_TRY(result, search(cid));
+      if (result) {
+        results.emplace_back(std::move(*result), std::move(callbacks));
+      }
+    }
+    index_lock.unlock();
+    for (auto &[result, callbacks] : results) {
+      for (auto &callback : callbacks) {
+        callback(result);
+      }
+    }
+    return std::move(parent);
+  }
+
+  outcome::result<void> MsgWaiter::revert(const TipsetCPtr &ts) {
+    OUTCOME_TRY(parent, ts->loadParent(*ipld));
+    std::lock_guard index_lock{index_mutex};
+    reverted.insert(ts->key);
+    auto batch{store->batch()};
+    OUTCOME_TRY(parent->visitMessages(
+        ipld, [&](auto, auto, auto &cid) -> outcome::result<void> {
+          auto key{messageKey(cid)};
+          if (store->contains(key)) {
+            OUTCOME_TRY(raw, store->get(key));
+            OUTCOME_TRY(inclusion, codec::cbor::decode<Inclusion>(raw));
+            if (inclusion.tipset == ts->key.cids()) {
+              OUTCOME_TRY(batch->remove(key));
+            }
+          }
+          return outcome::success();
+        }));
+    OUTCOME_TRY(batch->remove(tipsetKey(ts)));
+    return batch->commit();
+  }
+
+  void MsgWaiter::backfill(TipsetCPtr head) {
+    using Tails = std::vector<std::vector<CID>>;
+    auto save{[&](const Tails &tails) -> outcome::result<void> {
+      if (tails.empty()) {
+        return store->remove(kTailsKey);
+      }
+      OUTCOME_TRY(raw, codec::cbor::encode(tails));
+      return store->put(kTailsKey, raw);
+    }};
+    auto result{[&]() -> outcome::result<void> {
+      Tails tails;
+      if (store->contains(kTailsKey)) {
+        OUTCOME_TRY(raw, store->get(kTailsKey));
+        OUTCOME_TRYA(tails, codec::cbor::decode<Tails>(raw));
+      }
+      tails.push_back(head->key.cids());
+      while (!tails.empty()) {
+        OUTCOME_TRY(ts, primitives::tipset::Tipset::load(*ipld, tails.back()));
+        for (size_t i{1}; !stop && ts->height() > 0; ++i) {
+          OUTCOME_TRY(done, indexed(ts));
+          if (done) {
+            break;
+          }
+          OUTCOME_TRYA(ts, apply(ts, true));
+          if (i % kSaveTailEvery == 0) {
+            tails.back() = ts->key.cids();
+            OUTCOME_TRY(save(tails));
+          }
+        }
+        if (stop) {
+          tails.back() = ts->key.cids();
+          break;
+        }
+        tails.pop_back();
+      }
+      return save(tails);
+    }()};
+    if (!result) {
+      logError("backfill", result.error());
     }
   }
 }  // namespace fc::storage::blockchain
@@ -6,27 +6,73 @@
 #ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_MSG_WAITER_HPP
 #define CPP_FILECOIN_CORE_STORAGE_CHAIN_MSG_WAITER_HPP
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#include "storage/buffer_map.hpp"
 #include "storage/chain/chain_store.hpp"
 #include "vm/runtime/runtime_types.hpp"
 
 namespace fc::storage::blockchain {
+  using primitives::ChainEpoch;
   using vm::runtime::MessageReceipt;
 
+  /**
+   * Persistent index of message inclusions in canonical chain.
+   * Updated on head changes, chain below current head is indexed in
+   * background until already indexed tipset is reached.
+   */
   struct MsgWaiter : public std::enable_shared_from_this<MsgWaiter> {
     using Result = std::pair<MessageReceipt, TipsetKey>;
     using Callback = std::function<void(const Result &)>;
 
-    explicit MsgWaiter(IpldPtr ipld);
+    /// Message receipt is in parent receipts of tipset at index
+    struct Inclusion {
+      std::vector<CID> tipset;
+      uint64_t index;
+      ChainEpoch epoch;
+    };
+
+    MsgWaiter(IpldPtr ipld, std::shared_ptr<PersistentBufferMap> store);
+    ~MsgWaiter();
     static std::shared_ptr<MsgWaiter> create(
-        IpldPtr ipld, std::shared_ptr<ChainStore> chain_store);
+        IpldPtr ipld,
+        std::shared_ptr<PersistentBufferMap> store,
+        std::shared_ptr<ChainStore> chain_store);
     outcome::result<void> onHeadChange(const HeadChange &change);
+    /// Returns receipt and tipset of message, if message is indexed
+    outcome::result<boost::optional<Result>> search(const CID &cid) const;
     void wait(const CID &cid, const Callback &callback);
+    /// Waits for background indexing
+    void join();
 
     IpldPtr ipld;
+    std::shared_ptr<PersistentBufferMap> store;
     ChainStore::connection_t head_sub;
-    std::map<CID, Result> results;
+    std::mutex mutex;
     std::map<CID, std::vector<Callback>> waiting;
+
+   private:
+    outcome::result<bool> indexed(const TipsetCPtr &ts) const;
+    /**
+     * Indexes messages of tipset parent, receipts of which are in tipset.
+     * Backfill skips tipsets reverted by head changes.
+     */
+    outcome::result<TipsetCPtr> apply(const TipsetCPtr &ts, bool backfill);
+    outcome::result<void> revert(const TipsetCPtr &ts);
+    /// Indexes chain below head and resumes interrupted indexing
+    void backfill(TipsetCPtr head);
+
+    std::thread backfill_thread;
+    std::atomic_bool stop{false};
+    /// Serializes index updates from head changes and backfill
+    std::mutex index_mutex;
+    /// Tipsets reverted while backfill may still reach them
+    std::unordered_set<TipsetKey> reverted;
   };
+  CBOR_TUPLE(MsgWaiter::Inclusion, tipset, index, epoch)
 }  // namespace fc::storage::blockchain
 
 #endif  // CPP_FILECOIN_CORE_STORAGE_CHAIN_MSG_WAITER_HPP
@@ -0,0 +1,73 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/validity_store.hpp"
+
+#include "codec/cbor/cbor.hpp"
+
+namespace fc::storage::blockchain {
+  namespace {
+    const Buffer kHighestKey{Buffer{}.put("valid:highest")};
+
+    Buffer validKey(const TipsetKey &key) {
+      return Buffer{}.put("valid:").put(key.hash());
+    }
+  }  // namespace
+
+  ValidityStore::ValidityStore(std::shared_ptr<PersistentBufferMap> store,
+                               size_t cache)
+      : store{std::move(store)}, cache_{cache} {}
+
+  outcome::result<std::shared_ptr<ValidityStore>> ValidityStore::create(
+      std::shared_ptr<PersistentBufferMap> store, size_t cache) {
+    auto validity{std::make_shared<ValidityStore>(store, cache)};
+    if (store->contains(kHighestKey)) {
+      OUTCOME_TRY(raw, store->get(kHighestKey));
+      OUTCOME_TRY(highest, codec::cbor::decode<Highest>(raw));
+      validity->highest_ = std::move(highest);
+    }
+    return validity;
+  }
+
+  outcome::result<boost::optional<bool>> ValidityStore::get(
+      const TipsetKey &key) const {
+    std::lock_guard lock{mutex_};
+    if (auto valid{cache_.get(key)}) {
+      return *valid;
+    }
+    auto _key{validKey(key)};
+    if (!store->contains(_key)) {
+      return boost::none;
+    }
+    OUTCOME_TRY(raw, store->get(_key));
+    auto valid{!raw.empty() && raw[0] != 0};
+    cache_.put(key, valid);
+    return valid;
+  }
+
+  outcome::result<void> ValidityStore::set(const TipsetKey &key,
+                                           bool valid,
+                                           uint64_t height) {
+    std::lock_guard lock{mutex_};
+    auto batch{store->batch()};
+    OUTCOME_TRY(batch->put(validKey(key), Buffer{}.putUint8(valid)));
+    auto higher{valid && (!highest_ || height > highest_->height)};
+    if (higher) {
+      OUTCOME_TRY(raw, codec::cbor::encode(Highest{height, key.cids()}));
+      OUTCOME_TRY(batch->put(kHighestKey, raw));
+    }
+    OUTCOME_TRY(batch->commit());
+    cache_.put(key, valid);
+    if (higher) {
+      highest_ = Highest{height, key.cids()};
+    }
+    return outcome::success();
+  }
+
+  boost::optional<ValidityStore::Highest> ValidityStore::highest() const {
+    std::lock_guard lock{mutex_};
+    return highest_;
+  }
+}  // namespace fc::storage::blockchain
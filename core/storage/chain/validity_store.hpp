@@ -0,0 +1,57 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_VALIDITY_STORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_CHAIN_VALIDITY_STORE_HPP
+
+#include <mutex>
+
+#include "codec/cbor/streams_annotation.hpp"
+#include "common/lru_cache.hpp"
+#include "primitives/tipset/tipset_key.hpp"
+#include "storage/buffer_map.hpp"
+
+namespace fc::storage::blockchain {
+  using primitives::tipset::TipsetKey;
+
+  /**
+   * Persistent validity of synced tipsets, recent lookups are cached.
+   * Highest valid tipset is kept, so sync resumes from it after restart
+   * instead of validating chain from genesis again.
+   */
+  struct ValidityStore {
+    /// Default number of cached validities
+    static constexpr size_t kDefaultCache{1 << 16};
+
+    struct Highest {
+      uint64_t height{};
+      std::vector<CID> tipset;
+    };
+
+    ValidityStore(std::shared_ptr<PersistentBufferMap> store,
+                  size_t cache = kDefaultCache);
+    static outcome::result<std::shared_ptr<ValidityStore>> create(
+        std::shared_ptr<PersistentBufferMap> store,
+        size_t cache = kDefaultCache);
+
+    /// Returns validity of tipset, none if tipset was not validated
+    outcome::result<boost::optional<bool>> get(const TipsetKey &key) const;
+    outcome::result<void> set(const TipsetKey &key,
+                              bool valid,
+                              uint64_t height);
+    /// Highest valid tipset
+    boost::optional<Highest> highest() const;
+
+    std::shared_ptr<PersistentBufferMap> store;
+
+   private:
+    mutable std::mutex mutex_;
+    mutable common::LruCache<TipsetKey, bool> cache_;
+    boost::optional<Highest> highest_;
+  };
+  CBOR_TUPLE(ValidityStore::Highest, height, tipset)
+}  // namespace fc::storage::blockchain
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_CHAIN_VALIDITY_STORE_HPP
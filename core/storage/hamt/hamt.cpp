@@ -5,9 +5,8 @@
 
 #include "storage/hamt/hamt.hpp"
 
-#include <libp2p/crypto/sha/sha256.hpp>
-
 #include "common/which.hpp"
+#include "crypto/hasher/hasher.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::hamt, HamtError, e) {
   using fc::storage::hamt::HamtError;
@@ -88,7 +87,7 @@ namespace fc::storage::hamt {
   }
 
   outcome::result<CID> Hamt::flush() {
-    OUTCOME_TRY(flush(root_));
+    OUTCOME_TRY(flush({&root_}));
     return cid();
   }
 
@@ -97,8 +96,8 @@ namespace fc::storage::hamt {
   }
 
   std::vector<size_t> Hamt::keyToIndices(const std::string &key, int n) const {
-    std::vector<uint8_t> key_bytes(key.begin(), key.end());
-    auto hash = libp2p::crypto::sha256(key_bytes);
+    auto multihash{crypto::Hasher::sha2_256(common::span::cbytes(key))};
+    auto hash{multihash.getHash()};
     std::vector<size_t> indices;
     constexpr auto byte_bits = 8;
     auto max_bits = byte_bits * hash.size();
@@ -212,14 +211,26 @@ namespace fc::storage::hamt {
     return outcome::success();
   }
 
-  outcome::result<void> Hamt::flush(Node::Item &item) {
-    if (which<Node::Ptr>(item)) {
-      auto &node = *boost::get<Node::Ptr>(item);
-      for (auto &item2 : node.items) {
-        OUTCOME_TRY(flush(item2.second));
+  outcome::result<void> Hamt::flush(const std::vector<Node::Item *> &items) {
+    std::vector<Node::Item *> dirty, children;
+    std::vector<Node *> nodes;
+    for (auto item : items) {
+      if (which<Node::Ptr>(*item)) {
+        auto &node = *boost::get<Node::Ptr>(*item);
+        dirty.push_back(item);
+        nodes.push_back(&node);
+        for (auto &item2 : node.items) {
+          children.push_back(&item2.second);
+        }
       }
-      OUTCOME_TRY(cid, ipld->setCbor(node));
-      item = cid;
+    }
+    if (dirty.empty()) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(flush(children));
+    OUTCOME_TRY(cids, ipld->setCborBatch(nodes));
+    for (auto i{0u}; i < dirty.size(); ++i) {
+      *dirty[i] = std::move(cids[i]);
     }
     return outcome::success();
   }
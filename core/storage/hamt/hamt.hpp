@@ -210,7 +210,8 @@ namespace fc::storage::hamt {
                                  gsl::span<const size_t> indices,
                                  const std::string &key);
     static outcome::result<void> cleanShard(Node::Item &item);
-    outcome::result<void> flush(Node::Item &item);
+    /// Flush dirty items, nodes of same depth are hashed in one batch
+    outcome::result<void> flush(const std::vector<Node::Item *> &items);
     outcome::result<void> loadItem(Node::Item &item) const;
     outcome::result<void> visit(Node::Item &item, const Visitor &visitor);
 
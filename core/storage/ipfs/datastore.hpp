@@ -63,6 +63,31 @@ namespace fc::storage::ipfs {
       return std::move(key);
     }
 
+    /**
+     * @brief CBOR-serialize independent values and store, hashing them in
+     * one batch
+     * @param values - data to serialize and store
+     * @return cids of CBOR-serialized data in same order
+     */
+    template <typename T>
+    outcome::result<std::vector<CID>> setCborBatch(
+        const std::vector<T *> &values) {
+      std::vector<Value> bytes;
+      std::vector<gsl::span<const uint8_t>> inputs;
+      bytes.reserve(values.size());
+      inputs.reserve(values.size());
+      for (auto value : values) {
+        OUTCOME_TRY(encoded, encode(*value));
+        bytes.push_back(std::move(encoded));
+        inputs.emplace_back(bytes.back());
+      }
+      OUTCOME_TRY(keys, common::getCidsOf(inputs));
+      for (auto i{0u}; i < keys.size(); ++i) {
+        OUTCOME_TRY(set(keys[i], std::move(bytes[i])));
+      }
+      return std::move(keys);
+    }
+
     /// Get CBOR decoded value by CID
     template <typename T>
     outcome::result<T> getCbor(const CID &key) const {
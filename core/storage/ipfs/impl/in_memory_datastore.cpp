@@ -9,23 +9,27 @@ using fc::storage::ipfs::InMemoryDatastore;
 using Value = fc::storage::ipfs::IpfsDatastore::Value;
 
 fc::outcome::result<bool> InMemoryDatastore::contains(const CID &key) const {
+  std::shared_lock lock{mutex_};
   return storage_.find(key) != storage_.end();
 }
 
 fc::outcome::result<void> InMemoryDatastore::set(const CID &key, Value value) {
-  storage_[key] = value;
+  std::unique_lock lock{mutex_};
+  storage_[key] = std::move(value);
   return fc::outcome::success();
 }
 
 fc::outcome::result<Value> InMemoryDatastore::get(const CID &key) const {
-  OUTCOME_TRY(found, contains(key));
-  if (!found) {
+  std::shared_lock lock{mutex_};
+  auto it{storage_.find(key)};
+  if (it == storage_.end()) {
     return IpfsDatastoreError::kNotFound;
   }
-  return storage_.at(key);
+  return it->second;
 }
 
 fc::outcome::result<void> InMemoryDatastore::remove(const CID &key) {
+  std::unique_lock lock{mutex_};
   storage_.erase(key);
   return fc::outcome::success();
 }
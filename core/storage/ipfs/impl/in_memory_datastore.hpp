@@ -7,11 +7,13 @@
 #define CPP_FILECOIN_IPFS_IMPL_IN_MEMORY_DATASTORE_HPP
 
 #include <map>
+#include <shared_mutex>
 
 #include "storage/ipfs/datastore.hpp"
 
 namespace fc::storage::ipfs {
 
+  /// Thread safe in-memory datastore
   class InMemoryDatastore
       : public IpfsDatastore,
         public std::enable_shared_from_this<InMemoryDatastore> {
@@ -35,6 +37,7 @@ namespace fc::storage::ipfs {
     }
 
    private:
+    mutable std::shared_mutex mutex_;
     std::map<CID, Value> storage_;
   };
 
@@ -0,0 +1,171 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+
+#include <algorithm>
+
+#include "codec/cbor/cbor_decode_stream.hpp"
+
+namespace fc::storage::ipfs {
+  using codec::cbor::CborDecodeStream;
+
+  namespace {
+    void cborLinks(CborDecodeStream &s, std::vector<CID> &links) {
+      if (s.isCid()) {
+        CID cid;
+        s >> cid;
+        links.push_back(std::move(cid));
+      } else if (s.isList()) {
+        auto n{s.listLength()};
+        for (auto l{s.list()}; n != 0; --n) {
+          cborLinks(l, links);
+        }
+      } else if (s.isMap()) {
+        for (auto &p : s.map()) {
+          cborLinks(p.second, links);
+        }
+      } else {
+        s.next();
+      }
+    }
+  }  // namespace
+
+  OverlayDatastore::OverlayDatastore(IpldPtr base, size_t read_cache)
+      : base_{std::move(base)},
+        reads_{read_cache, [](const Value &value) { return value.size(); }} {}
+
+  outcome::result<bool> OverlayDatastore::contains(const CID &key) const {
+    if (writes_.count(key) != 0 || reads_.contains(key)) {
+      return true;
+    }
+    return base_->contains(key);
+  }
+
+  outcome::result<void> OverlayDatastore::set(const CID &key, Value value) {
+    writes_.emplace(key, std::move(value));
+    return outcome::success();
+  }
+
+  outcome::result<OverlayDatastore::Value> OverlayDatastore::get(
+      const CID &key) const {
+    auto it{writes_.find(key)};
+    if (it != writes_.end()) {
+      return it->second;
+    }
+    if (auto value{reads_.get(key)}) {
+      return std::move(*value);
+    }
+    OUTCOME_TRY(value, base_->get(key));
+    reads_.put(key, value);
+    return std::move(value);
+  }
+
+  outcome::result<void> OverlayDatastore::remove(const CID &key) {
+    writes_.erase(key);
+    return outcome::success();
+  }
+
+  void OverlayDatastore::reset() {
+    writes_.clear();
+  }
+
+  size_t OverlayDatastore::written() const {
+    return writes_.size();
+  }
+
+  outcome::result<size_t> OverlayDatastore::commit(
+      const std::vector<CID> &roots) {
+    std::vector<CID> queue{roots};
+    std::set<CID> visited;
+    size_t count{0};
+    while (!queue.empty()) {
+      auto cid{std::move(queue.back())};
+      queue.pop_back();
+      auto it{writes_.find(cid)};
+      // blocks not written to overlay are already in base with all children
+      if (it == writes_.end() || !visited.insert(cid).second) {
+        continue;
+      }
+      if (cid.content_type == libp2p::multi::MulticodecType::DAG_CBOR) {
+        try {
+          CborDecodeStream s{it->second};
+          cborLinks(s, queue);
+        } catch (std::system_error &e) {
+          return outcome::failure(e.code());
+        }
+      }
+      OUTCOME_TRY(base_->set(cid, it->second));
+      ++count;
+    }
+    reset();
+    return count;
+  }
+
+  std::shared_ptr<OverlayPool> OverlayPool::make(IpldPtr base,
+                                                 size_t max_roots,
+                                                 size_t max_idle) {
+    return std::shared_ptr<OverlayPool>{
+        new OverlayPool{std::move(base), max_roots, max_idle}};
+  }
+
+  OverlayPool::OverlayPool(IpldPtr base, size_t max_roots, size_t max_idle)
+      : base_{std::move(base)}, max_roots_{max_roots}, max_idle_{max_idle} {}
+
+  std::shared_ptr<OverlayDatastore> OverlayPool::acquire(const CID &root) {
+    std::unique_ptr<OverlayDatastore> overlay;
+    {
+      std::lock_guard lock{mutex_};
+      for (auto &[_root, idle] : roots_) {
+        if (_root == root && !idle.empty()) {
+          overlay = std::move(idle.back());
+          idle.pop_back();
+          break;
+        }
+      }
+    }
+    if (!overlay) {
+      overlay = std::make_unique<OverlayDatastore>(base_);
+    }
+    return {overlay.release(),
+            [weak{weak_from_this()}, root](OverlayDatastore *overlay) {
+              std::unique_ptr<OverlayDatastore> owned{overlay};
+              if (auto pool{weak.lock()}) {
+                pool->release(root, std::move(owned));
+              }
+            }};
+  }
+
+  size_t OverlayPool::idle() const {
+    std::lock_guard lock{mutex_};
+    size_t count{0};
+    for (auto &[root, idle] : roots_) {
+      count += idle.size();
+    }
+    return count;
+  }
+
+  void OverlayPool::release(const CID &root,
+                            std::unique_ptr<OverlayDatastore> overlay) {
+    overlay->reset();
+    std::lock_guard lock{mutex_};
+    auto it{std::find_if(roots_.begin(), roots_.end(), [&](auto &pair) {
+      return pair.first == root;
+    })};
+    if (it == roots_.end()) {
+      roots_.emplace_back(root, decltype(it->second){});
+      if (roots_.size() > max_roots_) {
+        roots_.erase(roots_.begin());
+      }
+      it = std::prev(roots_.end());
+    } else {
+      std::rotate(it, std::next(it), roots_.end());
+      it = std::prev(roots_.end());
+    }
+    if (it->second.size() < max_idle_) {
+      it->second.push_back(std::move(overlay));
+    }
+  }
+}  // namespace fc::storage::ipfs
@@ -0,0 +1,92 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "common/lru_cache.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+  /**
+   * Copy-on-write datastore over base store.
+   * Writes stay in overlay and are discarded with it, base is never written.
+   * Blocks read from base are cached, overlay is used by one execution at a
+   * time.
+   */
+  class OverlayDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<OverlayDatastore> {
+   public:
+    /// Default limit of cached bytes read from base
+    static constexpr size_t kDefaultReadCache{16 << 20};
+
+    explicit OverlayDatastore(IpldPtr base,
+                              size_t read_cache = kDefaultReadCache);
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    /// Removes only blocks written to overlay
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    /// Discards written blocks, keeps read cache
+    void reset();
+
+    /// Number of blocks written to overlay
+    size_t written() const;
+
+    /**
+     * Writes blocks reachable from roots, which were written to overlay, to
+     * base store and discards all writes.
+     * Blocks unreachable from roots, e.g. intermediate states, are not
+     * persisted.
+     * @return number of blocks written to base
+     */
+    outcome::result<size_t> commit(const std::vector<CID> &roots);
+
+   private:
+    IpldPtr base_;
+    std::map<CID, Value> writes_;
+    mutable common::LruCache<CID, Value> reads_;
+  };
+
+  /**
+   * Pool of overlays over base store, kept warm per state root.
+   * Overlays acquired for same root reuse blocks read by previous users.
+   */
+  class OverlayPool : public std::enable_shared_from_this<OverlayPool> {
+   public:
+    static std::shared_ptr<OverlayPool> make(IpldPtr base,
+                                             size_t max_roots = 4,
+                                             size_t max_idle = 2);
+
+    /// Returns overlay without writes, it returns to pool when released
+    std::shared_ptr<OverlayDatastore> acquire(const CID &root);
+
+    /// Number of idle overlays
+    size_t idle() const;
+
+   private:
+    OverlayPool(IpldPtr base, size_t max_roots, size_t max_idle);
+
+    void release(const CID &root, std::unique_ptr<OverlayDatastore> overlay);
+
+    IpldPtr base_;
+    size_t max_roots_, max_idle_;
+    mutable std::mutex mutex_;
+    /// Idle overlays by root, most recently used root last
+    std::vector<std::pair<CID, std::vector<std::unique_ptr<OverlayDatastore>>>>
+        roots_;
+  };
+}  // namespace fc::storage::ipfs
@@ -0,0 +1,60 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/resolve.hpp"
+
+#include <algorithm>
+
+#include <boost/algorithm/string.hpp>
+
+namespace fc::storage::ipld {
+  using codec::cbor::CborResolveError;
+
+  outcome::result<bool> followLink(const Ipld &ipld, CborDecodeStream &stream) {
+    if (!stream.isCid()) {
+      return false;
+    }
+    auto link{stream};
+    CID cid;
+    link >> cid;
+    if (cid.content_type != libp2p::multi::MulticodecType::DAG_CBOR) {
+      return false;
+    }
+    OUTCOME_TRY(raw, ipld.get(cid));
+    stream = CborDecodeStream{raw};
+    return true;
+  }
+
+  outcome::result<Buffer> resolvePath(const Ipld &ipld,
+                                      const CID &root,
+                                      Path path) {
+    if (root.content_type != libp2p::multi::MulticodecType::DAG_CBOR) {
+      return CborResolveError::kContainerExpected;
+    }
+    OUTCOME_TRY(raw, ipld.get(root));
+    if (path.empty()) {
+      return std::move(raw);
+    }
+    try {
+      CborDecodeStream s{raw};
+      for (auto &part : path) {
+        OUTCOME_TRY(followLink(ipld, s));
+        OUTCOME_TRY(codec::cbor::resolve(s, part));
+      }
+      return Buffer{s.raw()};
+    } catch (std::system_error &e) {
+      return outcome::failure(e.code());
+    }
+  }
+
+  outcome::result<Buffer> resolvePath(const Ipld &ipld,
+                                      const CID &root,
+                                      const std::string &path) {
+    std::vector<std::string> parts;
+    boost::split(parts, path, [](auto c) { return c == '/'; });
+    parts.erase(std::remove(parts.begin(), parts.end(), ""), parts.end());
+    return resolvePath(ipld, root, parts);
+  }
+}  // namespace fc::storage::ipld
@@ -0,0 +1,42 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPLD_RESOLVE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPLD_RESOLVE_HPP
+
+#include "codec/cbor/cbor_resolve.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipld {
+  using codec::cbor::CborDecodeStream;
+  using codec::cbor::Path;
+
+  /**
+   * If current element of stream is DAG-CBOR CID link, replaces stream with
+   * linked block, other links are left as is
+   * @return true if link was followed
+   */
+  outcome::result<bool> followLink(const Ipld &ipld, CborDecodeStream &stream);
+
+  /**
+   * Resolves path (i.e. "a/b/3/c") starting from root block, following CID
+   * links between blocks. Only blocks on the path are fetched and subobjects
+   * are not decoded.
+   * @param ipld - store to fetch blocks from
+   * @param root - cid of root block
+   * @param path - map keys and list indices
+   * @return raw CBOR bytes of resolved subobject
+   */
+  outcome::result<Buffer> resolvePath(const Ipld &ipld,
+                                      const CID &root,
+                                      Path path);
+
+  /// Resolves "/" separated path, empty parts are ignored
+  outcome::result<Buffer> resolvePath(const Ipld &ipld,
+                                      const CID &root,
+                                      const std::string &path);
+}  // namespace fc::storage::ipld
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPLD_RESOLVE_HPP
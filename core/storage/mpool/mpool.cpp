@@ -7,6 +7,7 @@
 #include "common/logger.hpp"
 #include "const.hpp"
 #include "vm/interpreter/interpreter.hpp"
+#include "vm/message/signature_verifier.hpp"
 #include "vm/runtime/env.hpp"
 #include "vm/state/impl/state_tree_impl.hpp"
 
@@ -18,10 +19,13 @@ namespace fc::storage::mpool {
   std::shared_ptr<Mpool> Mpool::create(
       IpldPtr ipld,
       std::shared_ptr<Interpreter> interpreter,
-      std::shared_ptr<ChainStore> chain_store) {
+      std::shared_ptr<ChainStore> chain_store,
+      std::shared_ptr<SignatureVerifier> verifier) {
     auto mpool{std::make_shared<Mpool>()};
     mpool->ipld = std::move(ipld);
+    mpool->overlays = OverlayPool::make(mpool->ipld);
     mpool->interpreter = std::move(interpreter);
+    mpool->verifier = std::move(verifier);
     mpool->head_sub = chain_store->subscribeHeadChanges([=](auto &change) {
       auto res{mpool->onHeadChange(change)};
       if (!res) {
@@ -62,9 +66,10 @@ namespace fc::storage::mpool {
       msg.gas_fee_cap = kMinimumBaseFee + 1;
       msg.gas_premium = 1;
       OUTCOME_TRY(interpeted, interpreter->interpret(ipld, head));
-      auto env{std::make_shared<vm::runtime::Env>(nullptr, ipld, head)};
+      auto overlay{overlays->acquire(interpeted.state_root)};
+      auto env{std::make_shared<vm::runtime::Env>(nullptr, overlay, head)};
       env->state_tree = std::make_shared<vm::state::StateTreeImpl>(
-          ipld, interpeted.state_root);
+          overlay, interpeted.state_root);
       ++env->epoch;
       auto _pending{by_from.find(msg.from)};
       if (_pending != by_from.end()) {
@@ -95,6 +100,17 @@ namespace fc::storage::mpool {
   }
 
   outcome::result<void> Mpool::add(const SignedMessage &message) {
+    if (verifier) {
+      // signature of sender not resolved in head state can't be checked, so
+      // message is rejected, execution doesn't check signatures
+      auto resolve{
+          head ? vm::runtime::keyResolver(ipld, head->getParentStateRoot())
+               : SignatureVerifier::ResolveKey{}};
+      OUTCOME_TRY(item, SignatureVerifier::item(message, resolve));
+      if (!item || !verifier->verify(*item)) {
+        return vm::message::MessageError::kVerificationFailure;
+      }
+    }
     if (message.signature.isBls()) {
       bls_cache.emplace(message.getCid(), message.signature);
     }
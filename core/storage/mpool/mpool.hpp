@@ -8,6 +8,7 @@
 
 #include "node/fwd.hpp"
 #include "storage/chain/chain_store.hpp"
+#include "storage/ipfs/impl/overlay_datastore.hpp"
 #include "vm/message/message.hpp"
 
 namespace fc::storage::mpool {
@@ -16,7 +17,9 @@ namespace fc::storage::mpool {
   using primitives::tipset::HeadChange;
   using primitives::tipset::Tipset;
   using storage::blockchain::ChainStore;
+  using storage::ipfs::OverlayPool;
   using vm::interpreter::Interpreter;
+  using vm::message::SignatureVerifier;
   using vm::message::SignedMessage;
   using vm::message::UnsignedMessage;
   using connection_t = boost::signals2::connection;
@@ -39,7 +42,8 @@ namespace fc::storage::mpool {
     static std::shared_ptr<Mpool> create(
         IpldPtr ipld,
         std::shared_ptr<Interpreter> interpreter,
-        std::shared_ptr<ChainStore> chain_store);
+        std::shared_ptr<ChainStore> chain_store,
+        std::shared_ptr<SignatureVerifier> verifier);
     std::vector<SignedMessage> pending() const;
     outcome::result<uint64_t> nonce(const Address &from) const;
     outcome::result<void> estimate(UnsignedMessage &message) const;
@@ -52,7 +56,10 @@ namespace fc::storage::mpool {
 
    private:
     IpldPtr ipld;
+    /// Speculative executions don't write to ipld
+    std::shared_ptr<OverlayPool> overlays;
     std::shared_ptr<Interpreter> interpreter;
+    std::shared_ptr<SignatureVerifier> verifier;
     ChainStore::connection_t head_sub;
     TipsetCPtr head;
     std::map<Address, Pending> by_from;
@@ -14,6 +14,7 @@
 namespace fc::storage::unixfs {
   using common::Buffer;
   using crypto::Hasher;
+  using libp2p::multi::HashType;
   using google::protobuf::io::CodedOutputStream;
   using google::protobuf::io::StringOutputStream;
 
@@ -23,6 +24,20 @@ namespace fc::storage::unixfs {
     return cid;
   }
 
+  /// Leaves of one node are hashed in one batch
+  outcome::result<std::vector<CID>> makeLeaves(
+      Ipld &ipld, gsl::span<const gsl::span<const uint8_t>> chunks) {
+    auto hashes{Hasher::calculateBatch(HashType::sha256, chunks)};
+    std::vector<CID> cids;
+    cids.reserve(chunks.size());
+    for (auto i{0u}; i < hashes.size(); ++i) {
+      cids.emplace_back(
+          CID::Version::V1, CID::Multicodec::RAW, std::move(hashes[i]));
+      OUTCOME_TRY(ipld.set(cids.back(), Ipld::Value{chunks[i]}));
+    }
+    return std::move(cids);
+  }
+
   struct PbBuilder {
     void _tag(uint64_t id, uint64_t value, bool str) {
       cs.WriteTag((id << 3) | (str ? 2 : 0));
@@ -101,12 +116,22 @@ namespace fc::storage::unixfs {
     Tree root;
     PbFileBuilder pb_file;
     PbNodeBuilder pb_node;
+    std::vector<CID> leaves;
+    if (height == 1) {
+      std::vector<gsl::span<const uint8_t>> chunks;
+      for (auto rest{data}; chunks.size() < max_links && !rest.empty();) {
+        chunks.push_back(rest.subspan(
+            0, std::min(chunk_size, static_cast<size_t>(rest.size()))));
+        rest = rest.subspan(chunks.back().size());
+      }
+      OUTCOME_TRYA(leaves, makeLeaves(ipld, chunks));
+    }
     for (auto i = 0u; i < max_links && !data.empty(); ++i) {
       Tree tree;
       if (height == 1) {
         tree.size = tree.file_size =
             std::min(chunk_size, static_cast<size_t>(data.size()));
-        OUTCOME_TRYA(tree.cid, makeLeaf(ipld, data.subspan(0, tree.file_size)));
+        tree.cid = std::move(leaves[i]);
         data = data.subspan(tree.file_size);
       } else {
         OUTCOME_TRYA(tree,
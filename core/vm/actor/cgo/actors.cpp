@@ -25,6 +25,25 @@
   }                                                                  \
   void rt_##name(Runtime &rt, CborDecodeStream &arg, CborEncodeStream &ret)
 
+/**
+ * Runtime method returning block bytes through runtime arena instead of
+ * encoding them into result. View is valid until next view method call.
+ */
+#define RUNTIME_VIEW_METHOD(name)                                    \
+  void rt_##name(Runtime &, CborDecodeStream &, CborEncodeStream &); \
+  extern "C" Raw name(Raw raw, Raw *view) {                          \
+    static auto &metric{crossingMetric(#name)};                      \
+    CrossingTimer timer{metric};                                     \
+    CborDecodeStream arg{gocArg(raw)};                               \
+    CborEncodeStream ret;                                            \
+    auto &rt{runtimes.at(arg.get<size_t>())};                        \
+    rt.arena.clear();                                                \
+    rt_##name(rt, arg, ret);                                         \
+    *view = cgoArg(rt.arena);                                        \
+    return gocRet(ret.data());                                       \
+  }                                                                  \
+  void rt_##name(Runtime &rt, CborDecodeStream &arg, CborEncodeStream &ret)
+
 namespace fc::vm::actor::cgo {
   using builtin::account::AccountActorState;
   using crypto::randomness::DomainSeparationTag;
@@ -61,11 +80,19 @@ namespace fc::vm::actor::cgo {
   struct Runtime {
     std::shared_ptr<Execution> exec;
     Address to;
+    /// Read-only for Go, holds bytes returned by view methods
+    Buffer arena;
   };
 
-  static std::map<size_t, Runtime> runtimes;
-  static size_t next_runtime{0};
+  /**
+   * Runtimes of invocations running on current thread.
+   * Go calls back into C++ on the thread which called into Go,
+   * so concurrent executions on different threads don't share registry.
+   */
+  static thread_local std::map<size_t, Runtime> runtimes;
+  static thread_local size_t next_runtime{0};
 
+  /// Only const verify is used, which is thread safe
   static storage::keystore::InMemoryKeyStore keystore{
       std::make_shared<crypto::bls::BlsProviderImpl>(),
       std::make_shared<crypto::secp256k1::Secp256k1ProviderImpl>()};
@@ -76,13 +103,17 @@ namespace fc::vm::actor::cgo {
                                  size_t method,
                                  BytesIn params) {
     CborEncodeStream arg;
-    auto id{next_runtime++};  // TODO: mod
+    auto id{next_runtime++};
     auto version{getNetworkVersion(exec->env->epoch)};
     arg << id << version << message.from << message.to
         << exec->env->epoch << message.value << code << method
         << params;
-    runtimes.emplace(id, Runtime{exec, message.to});
-    auto ret{cgoCall<cgoActorsInvoke>(arg)};
+    runtimes.emplace(id, Runtime{exec, message.to, {}});
+    auto ret{[&] {
+      static auto &metric{crossingMetric("cgoActorsInvoke")};
+      CrossingTimer timer{metric};
+      return cgoCall<cgoActorsInvoke>(arg);
+    }()};
     runtimes.erase(id);
     auto exit{ret.get<VMExitCode>()};
     if (exit != kOk) {
@@ -143,9 +174,10 @@ namespace fc::vm::actor::cgo {
                   : ts->ticketRandomness(ipld, tag, round, seed);
   }
 
-  RUNTIME_METHOD(gocRtIpldGet) {
+  RUNTIME_VIEW_METHOD(gocRtIpldGet) {
     if (auto value{ipldGet(ret, rt, arg.get<CID>())}) {
-      ret << kOk << *value;
+      rt.arena = std::move(*value);
+      ret << kOk;
     }
   }
 
@@ -340,11 +372,12 @@ namespace fc::vm::actor::cgo {
     }
   }
 
-  RUNTIME_METHOD(gocRtStateGet) {
+  RUNTIME_VIEW_METHOD(gocRtStateGet) {
     if (auto _actor{rt.exec->state_tree->get(rt.to)}) {
       auto &head{_actor.value().head};
       if (auto state{ipldGet(ret, rt, head)}) {
-        ret << kOk << true << *state;
+        rt.arena = std::move(*state);
+        ret << kOk << true;
         if (arg.get<bool>()) {
           ret << head;
         }
@@ -11,7 +11,7 @@
 extern "C" {
 #endif
 
-Raw gocRtIpldGet(Raw);
+Raw gocRtIpldGet(Raw, Raw *view);
 Raw gocRtIpldPut(Raw);
 Raw gocRtCharge(Raw);
 Raw gocRtRand(Raw);
@@ -26,7 +26,7 @@ Raw gocRtNewAddress(Raw);
 Raw gocRtCreateActor(Raw);
 Raw gocRtActorCode(Raw);
 Raw gocRtActorBalance(Raw);
-Raw gocRtStateGet(Raw);
+Raw gocRtStateGet(Raw, Raw *view);
 Raw gocRtStateCommit(Raw);
 Raw gocRtDeleteActor(Raw);
 
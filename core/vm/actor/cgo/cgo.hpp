@@ -20,12 +20,15 @@ void free(void *);
 #else
 
 #include "codec/cbor/cbor.hpp"
-
-#define GOC_METHOD(name)                    \
-  Buffer goc_##name(BytesIn);               \
-  extern "C" Raw name(Raw raw) {            \
-    return gocRet(goc_##name(gocArg(raw))); \
-  }                                         \
+#include "vm/actor/cgo/metrics.hpp"
+
+#define GOC_METHOD(name)                                            \
+  Buffer goc_##name(BytesIn);                                       \
+  extern "C" Raw name(Raw raw) {                                    \
+    static auto &metric{fc::vm::actor::cgo::crossingMetric(#name)}; \
+    fc::vm::actor::cgo::CrossingTimer timer{metric};                \
+    return gocRet(goc_##name(gocArg(raw)));                         \
+  }                                                                 \
   Buffer goc_##name(BytesIn arg)
 
 #define CBOR_METHOD(name)                                   \
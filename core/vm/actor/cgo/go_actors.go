@@ -236,8 +236,9 @@ var _ rt1.Store = &rt{}
 var _ rt2.Store = &rt{}
 
 func (rt *rt) StoreGet(c cid.Cid, o cbor.Unmarshaler) bool {
-	ret := rt.gocRet(C.gocRtIpldGet(rt.gocArg().cid(c).arg()))
-	if e := o.UnmarshalCBOR(bytes.NewReader(ret.bytes())); e != nil {
+	var view C.Raw
+	rt.gocRet(C.gocRtIpldGet(rt.gocArg().cid(c).arg(), &view))
+	if e := o.UnmarshalCBOR(bytes.NewReader(cgoArg(view))); e != nil {
 		rt.Abort(ExitFatal)
 	}
 	return true
@@ -356,9 +357,10 @@ func (rt *rt) Abort(exit exitcode.ExitCode) {
 }
 
 func (rt *rt) stateGet(o cbor.Unmarshaler, exit exitcode.ExitCode, cid_ bool) cid.Cid {
-	ret := rt.gocRet(C.gocRtStateGet(rt.gocArg().bool(cid_).arg()))
+	var view C.Raw
+	ret := rt.gocRet(C.gocRtStateGet(rt.gocArg().bool(cid_).arg(), &view))
 	if ret.bool() {
-		if e := o.UnmarshalCBOR(bytes.NewReader(ret.bytes())); e != nil {
+		if e := o.UnmarshalCBOR(bytes.NewReader(cgoArg(view))); e != nil {
 			rt.Abort(ExitFatal)
 		}
 		if cid_ {
@@ -0,0 +1,62 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/actor/cgo/metrics.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace fc::vm::actor::cgo {
+  static std::mutex mutex;
+  static std::map<std::string, std::unique_ptr<CrossingMetric>> metrics;
+
+  void CrossingMetric::add(std::chrono::nanoseconds time) {
+    auto ns{static_cast<uint64_t>(time.count())};
+    size_t bucket{0};
+    for (auto us{ns / 1000}; us != 0 && bucket + 1 < kCrossingBuckets;
+         us >>= 1) {
+      ++bucket;
+    }
+    count.fetch_add(1, std::memory_order_relaxed);
+    nanoseconds.fetch_add(ns, std::memory_order_relaxed);
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  CrossingMetric &crossingMetric(const std::string &name) {
+    std::lock_guard lock{mutex};
+    auto &metric{metrics[name]};
+    if (!metric) {
+      metric = std::make_unique<CrossingMetric>();
+    }
+    return *metric;
+  }
+
+  std::vector<CrossingStats> crossingStats() {
+    std::lock_guard lock{mutex};
+    std::vector<CrossingStats> result;
+    for (auto &[name, metric] : metrics) {
+      auto &stats{result.emplace_back()};
+      stats.name = name;
+      stats.count = metric->count.load();
+      stats.time = std::chrono::nanoseconds{metric->nanoseconds.load()};
+      for (auto i{0u}; i < kCrossingBuckets; ++i) {
+        stats.buckets[i] = metric->buckets[i].load();
+      }
+    }
+    return result;
+  }
+
+  void resetCrossingStats() {
+    std::lock_guard lock{mutex};
+    for (auto &[name, metric] : metrics) {
+      metric->count = 0;
+      metric->nanoseconds = 0;
+      for (auto &bucket : metric->buckets) {
+        bucket = 0;
+      }
+    }
+  }
+}  // namespace fc::vm::actor::cgo
@@ -0,0 +1,54 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace fc::vm::actor::cgo {
+  /// Number of latency buckets, bucket i counts [2^(i-1), 2^i) microseconds
+  constexpr size_t kCrossingBuckets{16};
+
+  /// Counters of calls crossing between C++ and Go, updated concurrently
+  struct CrossingMetric {
+    void add(std::chrono::nanoseconds time);
+
+    std::atomic_uint64_t count{};
+    std::atomic_uint64_t nanoseconds{};
+    std::array<std::atomic_uint64_t, kCrossingBuckets> buckets{};
+  };
+
+  /// Snapshot of crossing metric
+  struct CrossingStats {
+    std::string name;
+    uint64_t count{};
+    std::chrono::nanoseconds time{};
+    std::array<uint64_t, kCrossingBuckets> buckets{};
+  };
+
+  /// Returns metric by method name, reference stays valid
+  CrossingMetric &crossingMetric(const std::string &name);
+
+  /// Snapshot of all metrics
+  std::vector<CrossingStats> crossingStats();
+
+  void resetCrossingStats();
+
+  /// Adds time elapsed since construction to metric
+  struct CrossingTimer {
+    inline explicit CrossingTimer(CrossingMetric &metric)
+        : metric{metric}, start{std::chrono::steady_clock::now()} {}
+    inline ~CrossingTimer() {
+      metric.add(std::chrono::steady_clock::now() - start);
+    }
+
+    CrossingMetric &metric;
+    std::chrono::steady_clock::time_point start;
+  };
+}  // namespace fc::vm::actor::cgo
@@ -44,7 +44,7 @@ namespace fc::dvm {
     return logger;
   }()};
   DEFINE(logging){false};
-  DEFINE(indent){};
+  thread_local size_t indent{};
 
   void onCharge(GasAmount gas) {
     if (gas) {
@@ -31,7 +31,7 @@ namespace fc::dvm {
 
   extern common::Logger logger;
   extern bool logging;
-  extern size_t indent;
+  extern thread_local size_t indent;
 
   struct Indent {
     inline Indent() {
@@ -5,7 +5,12 @@
 
 #include "vm/interpreter/impl/interpreter_impl.hpp"
 
+#include <algorithm>
+#include <atomic>
+
 #include "const.hpp"
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+#include "storage/ipfs/ipfs_datastore_error.hpp"
 #include "vm/actor/builtin/cron/cron_actor.hpp"
 #include "vm/actor/builtin/reward/reward_actor.hpp"
 #include "vm/actor/impl/invoker_impl.hpp"
@@ -25,6 +30,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::vm::interpreter, InterpreterError, e) {
       return "InterpreterError: Tipset marked as bad";
     case E::kChainInconsistency:
       return "InterpreterError: chain inconsistency";
+    case E::kReplayNotSupported:
+      return "InterpreterError: replay is not supported by interpreter";
     default:
       break;
   }
@@ -43,10 +50,30 @@ namespace fc::vm::interpreter {
   using message::SignedMessage;
   using message::UnsignedMessage;
   using primitives::TokenAmount;
+  using primitives::block::BlockHeader;
   using primitives::block::MsgMeta;
   using primitives::tipset::MessageVisitor;
   using runtime::Env;
   using runtime::MessageReceipt;
+  using state::StateTreeImpl;
+  using storage::ipfs::OverlayDatastore;
+
+  namespace {
+    /// Cost of cron ticks of null rounds
+    struct {
+      std::atomic<uint64_t> epochs, nanoseconds, max_nanoseconds, blocks;
+    } null_round_stats;
+
+    void addNullRound(std::chrono::nanoseconds time) {
+      uint64_t ns(time.count());
+      ++null_round_stats.epochs;
+      null_round_stats.nanoseconds += ns;
+      auto &max_ns{null_round_stats.max_nanoseconds};
+      auto max{max_ns.load()};
+      while (max < ns && !max_ns.compare_exchange_weak(max, ns)) {
+      }
+    }
+  }  // namespace
 
   outcome::result<Result> InterpreterImpl::interpret(
       const IpldPtr &ipld, const TipsetCPtr &tipset) const {
@@ -63,6 +90,93 @@ namespace fc::vm::interpreter {
       const IpldPtr &ipld,
       const TipsetCPtr &tipset,
       std::vector<MessageReceipt> *all_receipts) const {
+    return execute(ipld, ipld, tipset, all_receipts, nullptr);
+  }
+
+  double InterpreterImpl::Replay::tipsetsPerSecond() const {
+    std::chrono::duration<double> seconds{time};
+    if (seconds.count() == 0) {
+      return 0;
+    }
+    return results.size() / seconds.count();
+  }
+
+  outcome::result<InterpreterImpl::Replay> InterpreterImpl::replay(
+      const IpldPtr &ipld,
+      const std::vector<TipsetCPtr> &segment,
+      size_t flush_every,
+      const ReplayCallback &on_result) const {
+    Replay replay;
+    if (segment.empty()) {
+      return replay;
+    }
+    auto start{std::chrono::steady_clock::now()};
+    auto overlay{std::make_shared<OverlayDatastore>(ipld)};
+    auto state_tree{std::make_shared<StateTreeImpl>(
+        overlay, segment[0]->getParentStateRoot())};
+    // receipts of all tipsets are persisted
+    std::vector<CID> receipts;
+    auto commit{[&]() -> outcome::result<void> {
+      auto roots{std::move(receipts)};
+      receipts.clear();
+      auto &results{replay.results};
+      for (auto i{results.size() < 2 ? 0 : results.size() - 2};
+           i < results.size();
+           ++i) {
+        if (replay.persisted.empty() || replay.persisted.back() < i) {
+          replay.persisted.push_back(i);
+        }
+        roots.push_back(results[i].state_root);
+      }
+      OUTCOME_TRY(overlay->commit(roots));
+      return outcome::success();
+    }};
+    for (auto i{0u}; i < segment.size(); ++i) {
+      auto &tipset{segment[i]};
+      if (i != 0) {
+        auto &previous{replay.results.back()};
+        if (tipset->getParents() != segment[i - 1]->key
+            || tipset->getParentStateRoot() != previous.state_root
+            || tipset->getParentMessageReceipts()
+                   != previous.message_receipts) {
+          break;
+        }
+      }
+      auto result{tipset->height() == 0
+                      ? outcome::result<Result>{Result{
+                          tipset->getParentStateRoot(),
+                          tipset->getParentMessageReceipts(),
+                      }}
+                      : execute(overlay, ipld, tipset, nullptr, state_tree)};
+      if (!result) {
+        replay.error = result.error();
+        break;
+      }
+      if (on_result) {
+        OUTCOME_TRY(accept, on_result(overlay, i, result.value()));
+        if (!accept) {
+          break;
+        }
+      }
+      receipts.push_back(result.value().message_receipts);
+      replay.results.push_back(std::move(result.value()));
+      if (flush_every != 0 && (i + 1) % flush_every == 0) {
+        OUTCOME_TRY(commit());
+      }
+    }
+    if (!replay.results.empty()) {
+      OUTCOME_TRY(commit());
+    }
+    replay.time = std::chrono::steady_clock::now() - start;
+    return replay;
+  }
+
+  outcome::result<Result> InterpreterImpl::execute(
+      const IpldPtr &ipld,
+      const IpldPtr &messages_ipld,
+      const TipsetCPtr &tipset,
+      std::vector<MessageReceipt> *all_receipts,
+      const std::shared_ptr<StateTreeImpl> &state_tree) const {
     auto on_receipt{[&](auto &receipt) {
       if (all_receipts) {
         all_receipts->push_back(receipt);
@@ -73,8 +187,25 @@ namespace fc::vm::interpreter {
       return InterpreterError::kDuplicateMiner;
     }
 
-    auto env =
-        std::make_shared<Env>(std::make_shared<InvokerImpl>(), ipld, tipset);
+    TipsetCPtr parent;
+    if (tipset->height() > 1) {
+      OUTCOME_TRYA(parent, tipset->loadParent(*messages_ipld));
+    }
+    auto null_rounds{parent ? tipset->height() - parent->height() - 1 : 0};
+
+    // cron of every null round flushes state snapshots on nested sends, they
+    // are kept in memory and only final state is written to store
+    std::shared_ptr<OverlayDatastore> overlay;
+    if (null_rounds != 0 && !state_tree) {
+      overlay = std::make_shared<OverlayDatastore>(ipld);
+    }
+
+    auto env = std::make_shared<Env>(std::make_shared<InvokerImpl>(),
+                                     overlay ? overlay : ipld,
+                                     tipset);
+    if (state_tree) {
+      env->state_tree = state_tree;
+    }
 
     auto cron{[&]() -> outcome::result<void> {
       OUTCOME_TRY(receipt,
@@ -89,31 +220,36 @@ namespace fc::vm::interpreter {
                       {},
                   }));
       if (receipt.exit_code != VMExitCode::kOk) {
-        return receipt.exit_code;
+        return InterpreterError::kCronTickFailed;
       }
       on_receipt(receipt);
       return outcome::success();
     }};
 
-    if (tipset->height() > 1) {
-      OUTCOME_TRY(parent, tipset->loadParent(*ipld));
+    if (null_rounds != 0) {
+      auto written{overlay ? overlay->written() : 0};
       for (auto epoch{parent->height() + 1}; epoch < tipset->height();
            ++epoch) {
+        auto start{std::chrono::steady_clock::now()};
         env->epoch = epoch;
         OUTCOME_TRY(cron());
+        addNullRound(std::chrono::steady_clock::now() - start);
       }
       env->epoch = tipset->height();
+      if (overlay) {
+        null_round_stats.blocks += overlay->written() - written;
+      }
     }
 
-    adt::Array<MessageReceipt> receipts{ipld};
-    MessageVisitor message_visitor{ipld};
+    adt::Array<MessageReceipt> receipts{env->ipld};
+    MessageVisitor message_visitor{messages_ipld};
     for (auto &block : tipset->blks) {
       AwardBlockReward::Params reward{
           block.miner, 0, 0, block.election_proof.win_count};
       OUTCOME_TRY(message_visitor.visit(
           block, [&](auto, auto bls, auto &cid) -> outcome::result<void> {
             UnsignedMessage message;
-            OUTCOME_TRY(raw, ipld->get(cid));
+            OUTCOME_TRY(raw, messages_ipld->get(cid));
             if (bls) {
               OUTCOME_TRYA(message, codec::cbor::decode<UnsignedMessage>(raw));
             } else {
@@ -142,7 +278,7 @@ namespace fc::vm::interpreter {
                       MethodParams{reward_encoded},
                   }));
       if (receipt.exit_code != VMExitCode::kOk) {
-        return receipt.exit_code;
+        return InterpreterError::kMinerSubmitFailed;
       }
       on_receipt(receipt);
     }
@@ -153,6 +289,10 @@ namespace fc::vm::interpreter {
 
     OUTCOME_TRY(Ipld::flush(receipts));
 
+    if (overlay) {
+      OUTCOME_TRY(overlay->commit({new_state_root, receipts.amt.cid()}));
+    }
+
     return Result{
         new_state_root,
         receipts.amt.cid(),
@@ -184,8 +324,35 @@ namespace fc::vm::interpreter {
       return boost::none;
     }
 
+    /// Receipts are stored next to result, key differs by prefix
+    common::Buffer receiptsKey(const common::Buffer &key) {
+      return common::Buffer{}.put("receipts:").putBuffer(key);
+    }
   }  // namespace
 
+  bool isConsensusFailure(const std::error_code &error) {
+    return error == InterpreterError::kDuplicateMiner
+           || error == InterpreterError::kMinerSubmitFailed
+           || error == InterpreterError::kCronTickFailed
+           || error == InterpreterError::kTipsetMarkedBad;
+  }
+
+  NullRoundStats nullRoundStats() {
+    return {
+        null_round_stats.epochs,
+        std::chrono::nanoseconds{null_round_stats.nanoseconds},
+        std::chrono::nanoseconds{null_round_stats.max_nanoseconds},
+        null_round_stats.blocks,
+    };
+  }
+
+  void resetNullRoundStats() {
+    null_round_stats.epochs = 0;
+    null_round_stats.nanoseconds = 0;
+    null_round_stats.max_nanoseconds = 0;
+    null_round_stats.blocks = 0;
+  }
+
   outcome::result<boost::optional<Result>> getSavedResult(
       const PersistentBufferMap &store,
       const primitives::tipset::TipsetCPtr &tipset) {
@@ -196,18 +363,141 @@ namespace fc::vm::interpreter {
   outcome::result<Result> CachedInterpreter::interpret(
       const IpldPtr &ipld, const TipsetCPtr &tipset) const {
     common::Buffer key(tipset->key.hash());
+    std::promise<outcome::result<Result>> promise;
+    boost::optional<std::shared_future<outcome::result<Result>>> other;
+    {
+      std::lock_guard lock{mutex};
+      if (auto result{cache.get(key)}) {
+        return *result;
+      }
+      auto it{pending.find(key)};
+      if (it != pending.end()) {
+        other = it->second;
+      } else {
+        pending.emplace(key, promise.get_future().share());
+      }
+    }
+    if (other) {
+      return other->get();
+    }
+    auto done{[&](const Result *result) {
+      std::lock_guard lock{mutex};
+      if (result) {
+        cache.put(key, *result);
+      }
+      pending.erase(key);
+    }};
+    try {
+      auto result{interpretUncached(ipld, tipset)};
+      done(result ? &result.value() : nullptr);
+      promise.set_value(result);
+      return result;
+    } catch (...) {
+      done(nullptr);
+      promise.set_exception(std::current_exception());
+      throw;
+    }
+  }
+
+  outcome::result<Result> CachedInterpreter::interpretUncached(
+      const IpldPtr &ipld, const TipsetCPtr &tipset) const {
+    common::Buffer key(tipset->key.hash());
     OUTCOME_TRY(saved_result, getSavedResult(*store, key));
     if (saved_result) {
       return saved_result.value();
     }
-    auto result = interpreter->interpret(ipld, tipset);
+    auto impl{std::dynamic_pointer_cast<InterpreterImpl>(interpreter)};
+    if (impl && tipset->height() != 0) {
+      OUTCOME_TRY(have_parent_state,
+                  ipld->contains(tipset->getParentStateRoot()));
+      if (!have_parent_state) {
+        OUTCOME_TRY(result, reexecute(ipld, *impl, tipset));
+        OUTCOME_TRY(saveResult(key, result));
+        return std::move(result);
+      }
+    }
+    std::vector<MessageReceipt> receipts;
+    auto with_receipts{save_receipts && impl && tipset->height() != 0};
+    auto result = with_receipts ? impl->applyBlocks(ipld, tipset, &receipts)
+                                : interpreter->interpret(ipld, tipset);
     if (!result) {
-      OUTCOME_TRY(raw, codec::cbor::encode(boost::optional<Result>{}));
-      OUTCOME_TRY(store->put(key, raw));
+      // tipset is executed again after local failure
+      if (isConsensusFailure(result.error())) {
+        OUTCOME_TRY(raw, codec::cbor::encode(boost::optional<Result>{}));
+        OUTCOME_TRY(store->put(key, raw));
+      }
     } else {
-      OUTCOME_TRY(raw, codec::cbor::encode(result.value()));
-      OUTCOME_TRY(store->put(key, raw));
+      if (with_receipts) {
+        OUTCOME_TRY(raw_receipts, codec::cbor::encode(receipts));
+        OUTCOME_TRY(store->put(receiptsKey(key), raw_receipts));
+      }
+      OUTCOME_TRY(saveResult(key, result.value()));
     }
     return result;
   }
+
+  outcome::result<Result> CachedInterpreter::reexecute(
+      const IpldPtr &ipld,
+      const InterpreterImpl &impl,
+      const TipsetCPtr &tipset) const {
+    std::vector<TipsetCPtr> segment{tipset};
+    while (true) {
+      auto &oldest{segment.back()};
+      OUTCOME_TRY(have_state, ipld->contains(oldest->getParentStateRoot()));
+      if (have_state) {
+        break;
+      }
+      if (oldest->height() == 0) {
+        return storage::ipfs::IpfsDatastoreError::kNotFound;
+      }
+      OUTCOME_TRY(parent, oldest->loadParent(*ipld));
+      segment.push_back(std::move(parent));
+    }
+    std::reverse(segment.begin(), segment.end());
+    // only states of last tipsets are persisted
+    OUTCOME_TRY(replay, impl.replay(ipld, segment, 0));
+    if (replay.results.size() != segment.size()) {
+      return InterpreterError::kChainInconsistency;
+    }
+    return std::move(replay.results.back());
+  }
+
+  outcome::result<void> CachedInterpreter::saveResult(
+      const common::Buffer &key, const Result &result) const {
+    OUTCOME_TRY(raw, codec::cbor::encode(result));
+    return store->put(key, raw);
+  }
+
+  outcome::result<InterpreterImpl::Replay> CachedInterpreter::replay(
+      const IpldPtr &ipld,
+      const std::vector<TipsetCPtr> &segment,
+      size_t flush_every,
+      const InterpreterImpl::ReplayCallback &on_result) const {
+    auto impl{std::dynamic_pointer_cast<InterpreterImpl>(interpreter)};
+    if (!impl) {
+      return InterpreterError::kReplayNotSupported;
+    }
+    OUTCOME_TRY(replay, impl->replay(ipld, segment, flush_every, on_result));
+    // results of other tipsets refer to states which were not persisted
+    for (auto i : replay.persisted) {
+      common::Buffer key(segment[i]->key.hash());
+      auto &result{replay.results[i]};
+      OUTCOME_TRY(saveResult(key, result));
+      std::lock_guard lock{mutex};
+      cache.put(key, result);
+    }
+    return std::move(replay);
+  }
+
+  outcome::result<boost::optional<std::vector<MessageReceipt>>>
+  CachedInterpreter::getReceipts(const TipsetCPtr &tipset) const {
+    auto key{receiptsKey(common::Buffer{tipset->key.hash()})};
+    if (!store->contains(key)) {
+      return boost::none;
+    }
+    OUTCOME_TRY(raw, store->get(key));
+    OUTCOME_TRY(receipts,
+                codec::cbor::decode<std::vector<MessageReceipt>>(raw));
+    return std::move(receipts);
+  }
 }  // namespace fc::vm::interpreter
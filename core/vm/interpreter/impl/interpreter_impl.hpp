@@ -6,14 +6,37 @@
 #ifndef CPP_FILECOIN_CORE_VM_INTERPRETER_INTERPRETER_IMPL_HPP
 #define CPP_FILECOIN_CORE_VM_INTERPRETER_INTERPRETER_IMPL_HPP
 
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+
+#include "common/lru_cache.hpp"
 #include "storage/buffer_map.hpp"
 #include "vm/interpreter/interpreter.hpp"
 #include "vm/runtime/runtime_types.hpp"
 
+namespace fc::vm::state {
+  class StateTreeImpl;
+}  // namespace fc::vm::state
+
 namespace fc::vm::interpreter {
   using storage::PersistentBufferMap;
   using vm::runtime::MessageReceipt;
 
+  /// Cost of cron ticks executed for null rounds
+  struct NullRoundStats {
+    uint64_t epochs{};
+    std::chrono::nanoseconds time{}, max_time{};
+    /// Blocks written by crons, kept in memory instead of store
+    uint64_t blocks{};
+  };
+
+  /// Returns cost of null round crons of all interpreters
+  NullRoundStats nullRoundStats();
+
+  void resetNullRoundStats();
+
   class InterpreterImpl : public Interpreter {
    public:
     outcome::result<Result> interpret(const IpldPtr &store,
@@ -23,24 +46,129 @@ namespace fc::vm::interpreter {
         const TipsetCPtr &tipset,
         std::vector<MessageReceipt> *all_receipts) const;
 
+    /// Default number of tipsets between durable writes of replay
+    static constexpr size_t kDefaultReplayFlush{32};
+
+    /// Results of chain segment replay
+    struct Replay {
+      /**
+       * Results of applied tipsets in segment order, replay stopped at
+       * tipset following last result
+       */
+      std::vector<Result> results;
+      /// Indices of results which state is persisted
+      std::vector<size_t> persisted;
+      /// Execution failure of tipset replay stopped at, empty if it stopped
+      /// for other reason
+      std::error_code error{};
+      std::chrono::nanoseconds time{};
+
+      double tipsetsPerSecond() const;
+    };
+
+    /**
+     * Called after tipset of segment is applied, its state is readable from
+     * store. Returns false to reject tipset and stop replay.
+     */
+    using ReplayCallback = std::function<outcome::result<bool>(
+        const IpldPtr &store, size_t index, const Result &result)>;
+
+    /**
+     * Applies linear chain segment, each tipset is child of previous, state
+     * of first tipset parent must be in store.
+     * One state tree is carried between tipsets, blocks of intermediate
+     * states stay in memory. Every `flush_every` tipsets and at the end,
+     * receipts and states of last two applied tipsets are written to store,
+     * so last tipset can be weighed and its children applied later.
+     * Replay stops at first tipset which fails or doesn't match results of
+     * previous tipset.
+     */
+    outcome::result<Replay> replay(
+        const IpldPtr &store,
+        const std::vector<TipsetCPtr> &segment,
+        size_t flush_every = kDefaultReplayFlush,
+        const ReplayCallback &on_result = {}) const;
+
    protected:
     using BlockHeader = primitives::block::BlockHeader;
 
    private:
     bool hasDuplicateMiners(const std::vector<BlockHeader> &blocks) const;
+
+    /**
+     * Applies tipset using state tree over vm store, messages are read from
+     * messages store.
+     */
+    outcome::result<Result> execute(
+        const IpldPtr &ipld,
+        const IpldPtr &messages_ipld,
+        const TipsetCPtr &tipset,
+        std::vector<MessageReceipt> *all_receipts,
+        const std::shared_ptr<state::StateTreeImpl> &state_tree) const;
   };
 
+  /**
+   * Persists results of interpreter, recent results are also kept in memory.
+   * Concurrent calls for same tipset share one execution.
+   */
   class CachedInterpreter : public Interpreter {
    public:
+    static constexpr size_t kDefaultCacheSize{64};
+
+    /**
+     * @param save_receipts - also persist receipts of all messages, including
+     * implicit, if interpreter is InterpreterImpl
+     */
     CachedInterpreter(std::shared_ptr<Interpreter> interpreter,
-                      std::shared_ptr<PersistentBufferMap> store)
-        : interpreter{std::move(interpreter)}, store{std::move(store)} {}
+                      std::shared_ptr<PersistentBufferMap> store,
+                      size_t cache_size = kDefaultCacheSize,
+                      bool save_receipts = false)
+        : interpreter{std::move(interpreter)},
+          store{std::move(store)},
+          save_receipts{save_receipts},
+          cache{cache_size} {}
     outcome::result<Result> interpret(const IpldPtr &store,
                                       const TipsetCPtr &tipset) const override;
 
+    /// Returns persisted receipts of tipset messages, if saved
+    outcome::result<boost::optional<std::vector<MessageReceipt>>> getReceipts(
+        const TipsetCPtr &tipset) const;
+
+    /**
+     * Replays segment with InterpreterImpl, results which state is persisted
+     * are saved
+     */
+    outcome::result<InterpreterImpl::Replay> replay(
+        const IpldPtr &ipld,
+        const std::vector<TipsetCPtr> &segment,
+        size_t flush_every = InterpreterImpl::kDefaultReplayFlush,
+        const InterpreterImpl::ReplayCallback &on_result = {}) const;
+
    private:
+    outcome::result<Result> interpretUncached(const IpldPtr &ipld,
+                                              const TipsetCPtr &tipset) const;
+
+    /**
+     * Executes tipset which parent state is not in store, e.g. it was not
+     * persisted by replay, starting from nearest ancestor with parent state
+     * in store. Failure is not persisted, as ancestors were executed before.
+     */
+    outcome::result<Result> reexecute(const IpldPtr &ipld,
+                                      const InterpreterImpl &impl,
+                                      const TipsetCPtr &tipset) const;
+
+    outcome::result<void> saveResult(const common::Buffer &key,
+                                     const Result &result) const;
+
     std::shared_ptr<Interpreter> interpreter;
     std::shared_ptr<PersistentBufferMap> store;
+    bool save_receipts;
+    mutable std::mutex mutex;
+    mutable common::LruCache<common::Buffer, Result> cache;
+    /// Executions in progress
+    mutable std::map<common::Buffer,
+                     std::shared_future<outcome::result<Result>>>
+        pending;
   };
 }  // namespace fc::vm::interpreter
 
@@ -17,6 +17,7 @@ namespace fc::vm::interpreter {
     kCronTickFailed,
     kTipsetMarkedBad,
     kChainInconsistency,
+    kReplayNotSupported,
   };
 
   struct Result {
@@ -36,6 +37,13 @@ namespace fc::vm::interpreter {
         const IpldPtr &store, const TipsetCPtr &tipset) const = 0;
   };
 
+  /**
+   * Failure of tipset execution, which rejects tipset by consensus rules.
+   * Only such failures are persisted as bad tipset, others are local, e.g.
+   * missing data or store I/O, and tipset is executed again.
+   */
+  bool isConsensusFailure(const std::error_code &error);
+
   /// returns persisted interpreter result for tipset, if exists,
   /// empty value if tipset is not yet interpreted,
   /// error if tipset is bad or store access error occured
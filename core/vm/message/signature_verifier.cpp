@@ -0,0 +1,173 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/message/signature_verifier.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+
+#include <boost/asio/post.hpp>
+
+#include "primitives/address/address_codec.hpp"
+#include "vm/message/message_util.hpp"
+
+namespace fc::vm::message {
+  using Clock = std::chrono::steady_clock;
+
+  /// Smaller batches are verified on caller thread
+  constexpr size_t kMinParallelBatch{4};
+
+  double SignatureVerifier::Metrics::throughput() const {
+    if (time.count() == 0) {
+      return 0;
+    }
+    return signatures / std::chrono::duration<double>(time).count();
+  }
+
+  SignatureVerifier::SignatureVerifier(std::shared_ptr<KeyStore> keystore,
+                                       size_t threads,
+                                       size_t cache_size)
+      : keystore_{std::move(keystore)},
+        threads_{std::max<size_t>(1, threads)},
+        pool_{threads_},
+        cache_{cache_size} {}
+
+  SignatureVerifier::SignatureVerifier(std::shared_ptr<KeyStore> keystore)
+      : SignatureVerifier{std::move(keystore),
+                          std::thread::hardware_concurrency()} {}
+
+  SignatureVerifier::~SignatureVerifier() {
+    pool_.join();
+  }
+
+  outcome::result<boost::optional<SignatureVerifier::Item>>
+  SignatureVerifier::item(const SignedMessage &message,
+                          const ResolveKey &resolve) {
+    auto key{message.message.from};
+    if (!key.isKeyType()) {
+      auto resolved{resolve ? resolve(key) : boost::none};
+      if (!resolved) {
+        return boost::none;
+      }
+      key = std::move(*resolved);
+    }
+    OUTCOME_TRY(message_cid, cid(message.message));
+    return Item{std::move(message_cid), message.signature, std::move(key)};
+  }
+
+  bool SignatureVerifier::verify(const Item &item) {
+    auto cache_key{key(item)};
+    if (cache_key) {
+      std::lock_guard lock{cache_mutex_};
+      if (cache_.get(*cache_key)) {
+        return true;
+      }
+    }
+    if (!verifyUncached(item)) {
+      return false;
+    }
+    if (cache_key) {
+      std::lock_guard lock{cache_mutex_};
+      cache_.put(*cache_key, true);
+    }
+    return true;
+  }
+
+  boost::optional<Buffer> SignatureVerifier::key(const Item &item) {
+    auto bytes{item.cid.toBytes()};
+    if (!bytes) {
+      return boost::none;
+    }
+    Buffer key{std::move(bytes.value())};
+    key.put(primitives::address::encode(item.address));
+    key.putBuffer(item.signature.toBytes());
+    return key;
+  }
+
+  bool SignatureVerifier::verifyUncached(const Item &item) const {
+    auto bytes{item.cid.toBytes()};
+    if (!bytes) {
+      return false;
+    }
+    auto valid{keystore_->verify(item.address, bytes.value(), item.signature)};
+    return valid && valid.value();
+  }
+
+  std::vector<bool> SignatureVerifier::verify(gsl::span<const Item> items) {
+    auto start{Clock::now()};
+    std::vector<uint8_t> valid(items.size());
+    std::vector<boost::optional<Buffer>> keys;
+    std::vector<size_t> misses;
+    keys.reserve(items.size());
+    {
+      std::lock_guard lock{cache_mutex_};
+      for (auto i{0u}; i < items.size(); ++i) {
+        keys.push_back(key(items[i]));
+        if (keys.back() && cache_.get(*keys.back())) {
+          valid[i] = true;
+        } else {
+          misses.push_back(i);
+        }
+      }
+    }
+    auto range{[&](size_t begin, size_t end) {
+      for (auto i{begin}; i < end; ++i) {
+        valid[misses[i]] = verifyUncached(items[misses[i]]);
+      }
+    }};
+    auto chunks{std::min<size_t>(threads_, misses.size() / kMinParallelBatch)};
+    if (chunks <= 1) {
+      range(0, misses.size());
+    } else {
+      std::mutex mutex;
+      std::condition_variable done;
+      auto chunk{(misses.size() + chunks - 1) / chunks};
+      auto remaining{(misses.size() + chunk - 1) / chunk};
+      for (size_t begin{0}; begin < misses.size(); begin += chunk) {
+        auto end{std::min<size_t>(begin + chunk, misses.size())};
+        boost::asio::post(pool_, [&, begin, end] {
+          range(begin, end);
+          std::lock_guard lock{mutex};
+          if (--remaining == 0) {
+            done.notify_one();
+          }
+        });
+      }
+      std::unique_lock lock{mutex};
+      done.wait(lock, [&] { return remaining == 0; });
+    }
+    {
+      std::lock_guard lock{cache_mutex_};
+      for (auto i : misses) {
+        if (valid[i] && keys[i]) {
+          cache_.put(*keys[i], true);
+        }
+      }
+    }
+    count(items.size(),
+          std::count(valid.begin(), valid.end(), 0),
+          items.size() - misses.size(),
+          Clock::now() - start);
+    return {valid.begin(), valid.end()};
+  }
+
+  SignatureVerifier::Metrics SignatureVerifier::metrics() const {
+    std::lock_guard lock{metrics_mutex_};
+    return metrics_;
+  }
+
+  void SignatureVerifier::count(size_t signatures,
+                                size_t invalid,
+                                size_t cache_hits,
+                                std::chrono::nanoseconds time) {
+    std::lock_guard lock{metrics_mutex_};
+    ++metrics_.batches;
+    metrics_.signatures += signatures;
+    metrics_.invalid += invalid;
+    metrics_.cache_hits += cache_hits;
+    metrics_.time += time;
+  }
+}  // namespace fc::vm::message
@@ -0,0 +1,110 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_MESSAGE_SIGNATURE_VERIFIER_HPP
+#define CPP_FILECOIN_CORE_VM_MESSAGE_SIGNATURE_VERIFIER_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include "common/lru_cache.hpp"
+#include "storage/keystore/keystore.hpp"
+#include "vm/message/message.hpp"
+
+namespace fc::vm::message {
+  using storage::keystore::KeyStore;
+
+  /**
+   * Verifies message signatures in batches on a thread pool.
+   * Shared by block validation, mpool and blocksync.
+   * Valid signatures are cached, so message seen in gossip, mpool and block
+   * is verified once.
+   */
+  class SignatureVerifier {
+   public:
+    /// Signature over unsigned message cid bytes
+    struct Item {
+      CID cid;
+      Signature signature;
+      Address address;
+    };
+
+    struct Metrics {
+      uint64_t batches{};
+      uint64_t signatures{};
+      uint64_t invalid{};
+      uint64_t cache_hits{};
+      std::chrono::nanoseconds time{};
+
+      /// Verified signatures per second
+      double throughput() const;
+    };
+
+    /// Resolves sender to key address, none if it is not known before
+    /// execution
+    using ResolveKey =
+        std::function<boost::optional<Address>(const Address &)>;
+
+    /// Default number of cached valid signatures
+    static constexpr size_t kDefaultCacheSize{1 << 16};
+
+    /**
+     * @param keystore - used only to verify signatures
+     * @param threads - thread pool size
+     * @param cache_size - max number of cached valid signatures
+     */
+    SignatureVerifier(std::shared_ptr<KeyStore> keystore,
+                      size_t threads,
+                      size_t cache_size = kDefaultCacheSize);
+    explicit SignatureVerifier(std::shared_ptr<KeyStore> keystore);
+    ~SignatureVerifier();
+
+    /**
+     * Makes item from signed message, signature is checked against key
+     * address of sender
+     * @return none if sender key address is not resolved, signature is left
+     * unchecked
+     */
+    static outcome::result<boost::optional<Item>> item(
+        const SignedMessage &message, const ResolveKey &resolve);
+
+    /// Verifies single signature on caller thread
+    bool verify(const Item &item);
+
+    /**
+     * Verifies signatures in parallel, blocks until all are verified
+     * @return bitmap, true for valid signatures
+     */
+    std::vector<bool> verify(gsl::span<const Item> items);
+
+    Metrics metrics() const;
+
+   private:
+    /**
+     * Cache key, cid bytes followed by key address and signature bytes.
+     * Key address of id sender depends on state it was resolved in.
+     * @return none if cid is not encoded, item is not cached
+     */
+    static boost::optional<Buffer> key(const Item &item);
+    bool verifyUncached(const Item &item) const;
+    void count(size_t signatures,
+               size_t invalid,
+               size_t cache_hits,
+               std::chrono::nanoseconds time);
+
+    std::shared_ptr<KeyStore> keystore_;
+    size_t threads_;
+    boost::asio::thread_pool pool_;
+    std::mutex cache_mutex_;
+    common::LruCache<Buffer, bool> cache_;
+    mutable std::mutex metrics_mutex_;
+    Metrics metrics_;
+  };
+}  // namespace fc::vm::message
+
+#endif  // CPP_FILECOIN_CORE_VM_MESSAGE_SIGNATURE_VERIFIER_HPP
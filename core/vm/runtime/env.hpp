@@ -11,6 +11,7 @@
 #include "storage/hamt/hamt.hpp"
 #include "vm/actor/invoker.hpp"
 #include "vm/runtime/pricelist.hpp"
+#include "vm/runtime/profiler.hpp"
 #include "vm/state/impl/state_tree_impl.hpp"
 
 namespace fc::vm::runtime {
@@ -19,10 +20,18 @@ namespace fc::vm::runtime {
   using state::StateTree;
   using state::StateTreeImpl;
 
-  outcome::result<Address> resolveKey(StateTree &state_tree,
+  /// Resolve key address of account actor, cached by state tree
+  outcome::result<Address> resolveKey(StateTreeImpl &state_tree,
                                       const Address &address,
                                       bool no_actor = false);
 
+  /**
+   * Returns resolver of key addresses in state, it returns none if address
+   * is not resolved, e.g. state is not computed yet
+   */
+  std::function<boost::optional<Address>(const Address &)> keyResolver(
+      IpldPtr ipld, const CID &state_root);
+
   /// Environment contains objects that are shared by runtime contexts
   struct Env : std::enable_shared_from_this<Env> {
     Env(std::shared_ptr<Invoker> invoker, IpldPtr ipld, TipsetCPtr tipset)
@@ -31,7 +40,15 @@ namespace fc::vm::runtime {
           invoker{std::move(invoker)},
           ipld{std::move(ipld)},
           epoch{tipset->height()},
-          tipset{std::move(tipset)} {}
+          tipset{std::move(tipset)},
+          profiler{runtime::profiler},
+          profile{profiler ? std::make_unique<EnvProfile>(epoch) : nullptr} {}
+
+    ~Env() {
+      if (profile) {
+        profiler->add(std::move(*profile));
+      }
+    }
 
     struct Apply {
       MessageReceipt receipt;
@@ -50,6 +67,9 @@ namespace fc::vm::runtime {
     uint64_t epoch; // mutable epoch for cron()
     TipsetCPtr tipset;
     Pricelist pricelist;
+    std::shared_ptr<Profiler> profiler;
+    /// Null when profiling is disabled
+    std::unique_ptr<EnvProfile> profile;
   };
 
   struct Execution : std::enable_shared_from_this<Execution> {
@@ -5,6 +5,8 @@
 
 #include "vm/runtime/env.hpp"
 
+#include <gsl/gsl_util>
+
 #include "vm/actor/builtin/account/account_actor.hpp"
 #include "vm/actor/cgo/actors.hpp"
 #include "vm/exit_code/exit_code.hpp"
@@ -21,12 +23,15 @@ namespace fc::vm::runtime {
   using actor::kSystemActorAddress;
   using storage::hamt::HamtError;
 
-  outcome::result<Address> resolveKey(StateTree &state_tree,
+  outcome::result<Address> resolveKey(StateTreeImpl &state_tree,
                                       const Address &address,
                                       bool no_actor) {
     if (address.isKeyType()) {
       return address;
     }
+    if (auto key{state_tree.cachedKey(address)}) {
+      return *key;
+    }
     if (auto _actor{state_tree.get(address)}) {
       auto &actor{_actor.value()};
       if (actor.code == kAccountCodeCid) {
@@ -35,6 +40,9 @@ namespace fc::vm::runtime {
                     ->getCbor<actor::builtin::account::AccountActorState>(
                         actor.head)}) {
           auto &key{_state.value().address};
+          if (key.isKeyType()) {
+            state_tree.cacheKey(address, key);
+          }
           if (!no_actor || key.isKeyType()) {
             return key;
           }
@@ -44,6 +52,19 @@ namespace fc::vm::runtime {
     return VMExitCode::kSysErrInvalidParameters;
   }
 
+  std::function<boost::optional<Address>(const Address &)> keyResolver(
+      IpldPtr ipld, const CID &state_root) {
+    auto state_tree{
+        std::make_shared<StateTreeImpl>(std::move(ipld), state_root)};
+    return [state_tree](auto &address) -> boost::optional<Address> {
+      auto _key{resolveKey(*state_tree, address, true)};
+      if (!_key || !_key.value().isKeyType()) {
+        return boost::none;
+      }
+      return _key.value();
+    };
+  }
+
   outcome::result<Env::Apply> Env::applyMessage(const UnsignedMessage &message,
                                                 size_t size) {
     TokenAmount locked;
@@ -60,6 +81,14 @@ namespace fc::vm::runtime {
     if (message.gas_limit <= 0) {
       return RuntimeError::kUnknown;
     }
+    if (profile) {
+      profile->beginMessage(message);
+    }
+    auto end_message{gsl::finally([&] {
+      if (profile) {
+        profile->endMessage();
+      }
+    })};
     auto execution = Execution::make(shared_from_this(), message);
     Apply apply;
     auto msg_gas_cost{pricelist.onChainMessage(size)};
@@ -163,6 +192,14 @@ namespace fc::vm::runtime {
       UnsignedMessage message) {
     OUTCOME_TRY(from, state_tree->get(message.from));
     message.nonce = from.nonce;
+    if (profile) {
+      profile->beginMessage(message);
+    }
+    auto end_message{gsl::finally([&] {
+      if (profile) {
+        profile->endMessage();
+      }
+    })};
     auto execution = Execution::make(shared_from_this(), message);
     auto result = execution->send(message);
     if (result.has_error() && !isVMExitCode(result.error())) {
@@ -181,6 +218,9 @@ namespace fc::vm::runtime {
 
   outcome::result<void> Execution::chargeGas(GasAmount amount) {
     dvm::onCharge(amount);
+    if (env->profile) {
+      env->profile->charge(amount);
+    }
 
     gas_used += amount;
     if (gas_used > gas_limit) {
@@ -257,6 +297,16 @@ namespace fc::vm::runtime {
     OUTCOME_TRY(caller_id, state_tree->lookupId(message.from));
     RuntimeImpl runtime{shared_from_this(), message, caller_id};
 
+    auto &profile{env->profile};
+    if (profile) {
+      profile->enter(to_actor.code, message.method);
+    }
+    auto leave{gsl::finally([&] {
+      if (profile) {
+        profile->leave();
+      }
+    })};
+
     if (message.value != 0) {
       if (message.value < 0) {
         return VMExitCode::kSysErrForbidden;
@@ -292,6 +342,9 @@ namespace fc::vm::runtime {
     auto execution{execution_.lock()};
     OUTCOME_TRY(execution->chargeGas(
         execution->env->pricelist.onIpldPut(value.size())));
+    if (auto &profile{execution->env->profile}) {
+      profile->put(value.size());
+    }
     return execution->env->ipld->set(key, std::move(value));
   }
 
@@ -299,6 +352,9 @@ namespace fc::vm::runtime {
     auto execution{execution_.lock()};
     OUTCOME_TRY(execution->chargeGas(execution->env->pricelist.onIpldGet()));
     OUTCOME_TRY(value, execution->env->ipld->get(key));
+    if (auto &profile{execution->env->profile}) {
+      profile->get(value.size());
+    }
     return std::move(value);
   }
 }  // namespace fc::vm::runtime
@@ -0,0 +1,187 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/profiler.hpp"
+
+#include <cstdlib>
+
+#include "common/file.hpp"
+#include "common/span.hpp"
+#include "vm/message/message.hpp"
+
+namespace fc::vm::runtime {
+  using libp2p::multi::HashType;
+
+  /// Builtin actor code is identity hash of its name
+  std::string codeName(const CID &code) {
+    auto &hash{code.content_address};
+    if (hash.getType() == HashType::identity) {
+      auto name{hash.getHash()};
+      return {name.begin(), name.end()};
+    }
+    if (auto str{code.toString()}) {
+      return str.value();
+    }
+    return "?";
+  }
+
+  void ProfileStats::add(const ProfileStats &other) {
+    calls += other.calls;
+    time += other.time;
+    self_time += other.self_time;
+    gas += other.gas;
+    gets += other.gets;
+    get_bytes += other.get_bytes;
+    puts += other.puts;
+    put_bytes += other.put_bytes;
+  }
+
+  EnvProfile::EnvProfile(ChainEpoch height) {
+    tipset_.height = height;
+  }
+
+  template <typename F>
+  void EnvProfile::count(const F &f) {
+    if (!frames_.empty()) {
+      f(frames_.back().stats);
+    }
+    if (message_) {
+      f(message_->stats);
+    }
+    f(tipset_.stats);
+  }
+
+  void EnvProfile::beginMessage(const UnsignedMessage &message) {
+    message_ = MessageProfile{message.from, message.to, message.method, {}};
+    message_start_ = Clock::now();
+  }
+
+  void EnvProfile::endMessage() {
+    if (!message_) {
+      return;
+    }
+    auto &stats{message_->stats};
+    stats.calls = 1;
+    stats.time = stats.self_time = Clock::now() - message_start_;
+    tipset_.stats.calls += stats.calls;
+    tipset_.stats.time += stats.time;
+    tipset_.stats.self_time += stats.self_time;
+    tipset_.messages.push_back(std::move(*message_));
+    message_.reset();
+  }
+
+  void EnvProfile::enter(const CID &code, uint64_t method) {
+    auto name{codeName(code) + ":" + std::to_string(method)};
+    auto &frame{frames_.emplace_back()};
+    frame.method = {code, method};
+    frame.stack = frames_.size() == 1
+                      ? name
+                      : frames_[frames_.size() - 2].stack + ";" + name;
+    frame.start = Clock::now();
+  }
+
+  void EnvProfile::leave() {
+    if (frames_.empty()) {
+      return;
+    }
+    auto frame{std::move(frames_.back())};
+    frames_.pop_back();
+    auto &stats{frame.stats};
+    stats.calls = 1;
+    stats.time = Clock::now() - frame.start;
+    stats.self_time = stats.time - frame.nested;
+    if (!frames_.empty()) {
+      frames_.back().nested += stats.time;
+    }
+    methods_[frame.method].add(stats);
+    folded_[frame.stack] += stats.self_time;
+  }
+
+  void EnvProfile::charge(GasAmount gas) {
+    count([&](ProfileStats &stats) { stats.gas += gas; });
+  }
+
+  void EnvProfile::get(size_t bytes) {
+    count([&](ProfileStats &stats) {
+      ++stats.gets;
+      stats.get_bytes += bytes;
+    });
+  }
+
+  void EnvProfile::put(size_t bytes) {
+    count([&](ProfileStats &stats) {
+      ++stats.puts;
+      stats.put_bytes += bytes;
+    });
+  }
+
+  Profiler::Profiler(size_t max_tipsets) : max_tipsets_{max_tipsets} {}
+
+  void Profiler::add(EnvProfile &&profile) {
+    std::lock_guard lock{mutex_};
+    for (auto &[method, stats] : profile.methods_) {
+      methods_[method].add(stats);
+    }
+    for (auto &[stack, time] : profile.folded_) {
+      folded_[stack] += time;
+    }
+    tipsets_.push_back(std::move(profile.tipset_));
+    while (tipsets_.size() > max_tipsets_) {
+      tipsets_.pop_front();
+    }
+  }
+
+  std::vector<MethodProfile> Profiler::methods() const {
+    std::lock_guard lock{mutex_};
+    std::vector<MethodProfile> result;
+    result.reserve(methods_.size());
+    for (auto &[method, stats] : methods_) {
+      result.push_back({method.first, method.second, stats});
+    }
+    return result;
+  }
+
+  std::vector<TipsetProfile> Profiler::tipsets() const {
+    std::lock_guard lock{mutex_};
+    return {tipsets_.begin(), tipsets_.end()};
+  }
+
+  std::string Profiler::flamegraph() const {
+    std::lock_guard lock{mutex_};
+    std::string result;
+    for (auto &[stack, time] : folded_) {
+      auto us{std::chrono::duration_cast<std::chrono::microseconds>(time)};
+      if (us.count() > 0) {
+        result += stack + " " + std::to_string(us.count()) + "\n";
+      }
+    }
+    return result;
+  }
+
+  outcome::result<void> Profiler::dumpFlamegraph(
+      const std::string &path) const {
+    auto folded{flamegraph()};
+    return common::writeFile(path, common::span::cbytes(folded));
+  }
+
+  void Profiler::clear() {
+    std::lock_guard lock{mutex_};
+    methods_.clear();
+    tipsets_.clear();
+    folded_.clear();
+  }
+
+  std::shared_ptr<Profiler> profiler{
+      getenv("VM_PROFILE") ? std::make_shared<Profiler>() : nullptr};
+}  // namespace fc::vm::runtime
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::vm::runtime, ProfilerError, e) {
+  using fc::vm::runtime::ProfilerError;
+  switch (e) {
+    case ProfilerError::kDisabled:
+      return "VM profiler: VM_PROFILE is not set";
+  }
+  return "VM profiler: unknown error";
+}
@@ -0,0 +1,145 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+
+#include <boost/optional.hpp>
+
+#include "common/outcome.hpp"
+#include "node/fwd.hpp"
+#include "primitives/address/address.hpp"
+#include "primitives/cid/cid.hpp"
+#include "primitives/types.hpp"
+
+namespace fc::vm::runtime {
+  using message::UnsignedMessage;
+  using primitives::ChainEpoch;
+  using primitives::GasAmount;
+  using primitives::address::Address;
+  using Clock = std::chrono::steady_clock;
+
+  /// Resources used by calls
+  struct ProfileStats {
+    void add(const ProfileStats &other);
+
+    uint64_t calls{};
+    /// Including nested calls
+    std::chrono::nanoseconds time{};
+    /// Excluding nested calls
+    std::chrono::nanoseconds self_time{};
+    GasAmount gas{};
+    uint64_t gets{}, get_bytes{};
+    uint64_t puts{}, put_bytes{};
+  };
+
+  /// Aggregated calls of actor method
+  struct MethodProfile {
+    CID code;
+    uint64_t method{};
+    ProfileStats stats;
+  };
+
+  /// Message with all its nested calls
+  struct MessageProfile {
+    Address from, to;
+    uint64_t method{};
+    ProfileStats stats;
+  };
+
+  struct TipsetProfile {
+    ChainEpoch height{};
+    ProfileStats stats;
+    std::vector<MessageProfile> messages;
+  };
+
+  /**
+   * Collects profile of single Env.
+   * Not thread safe, Env executes messages sequentially.
+   */
+  class EnvProfile {
+   public:
+    explicit EnvProfile(ChainEpoch height);
+
+    void beginMessage(const UnsignedMessage &message);
+    void endMessage();
+
+    /// Actor method call started
+    void enter(const CID &code, uint64_t method);
+    /// Actor method call finished
+    void leave();
+
+    void charge(GasAmount gas);
+    void get(size_t bytes);
+    void put(size_t bytes);
+
+   private:
+    friend class Profiler;
+
+    struct Frame {
+      std::pair<CID, uint64_t> method;
+      std::string stack;
+      Clock::time_point start;
+      std::chrono::nanoseconds nested{};
+      ProfileStats stats;
+    };
+
+    /// Adds counters to current frame, message and tipset
+    template <typename F>
+    void count(const F &f);
+
+    TipsetProfile tipset_;
+    boost::optional<MessageProfile> message_;
+    Clock::time_point message_start_;
+    std::vector<Frame> frames_;
+    std::map<std::pair<CID, uint64_t>, ProfileStats> methods_;
+    /// Self time by semicolon separated call stack
+    std::map<std::string, std::chrono::nanoseconds> folded_;
+  };
+
+  /// Aggregates profiles of Env executions, thread safe
+  class Profiler {
+   public:
+    explicit Profiler(size_t max_tipsets = 64);
+
+    void add(EnvProfile &&profile);
+
+    std::vector<MethodProfile> methods() const;
+
+    /// Recent tipsets, oldest first
+    std::vector<TipsetProfile> tipsets() const;
+
+    /// Folded stacks with self time in microseconds, for flamegraph.pl
+    std::string flamegraph() const;
+
+    outcome::result<void> dumpFlamegraph(const std::string &path) const;
+
+    void clear();
+
+   private:
+    size_t max_tipsets_;
+    mutable std::mutex mutex_;
+    std::map<std::pair<CID, uint64_t>, ProfileStats> methods_;
+    std::deque<TipsetProfile> tipsets_;
+    std::map<std::string, std::chrono::nanoseconds> folded_;
+  };
+
+  /**
+   * Profiler used by new Env, null when profiling is disabled.
+   * Enabled on start by VM_PROFILE environment variable,
+   * must not be changed while executing.
+   */
+  extern std::shared_ptr<Profiler> profiler;
+
+  enum class ProfilerError {
+    kDisabled = 1,
+  };
+}  // namespace fc::vm::runtime
+
+OUTCOME_HPP_DECLARE_ERROR(fc::vm::runtime, ProfilerError);
@@ -17,7 +17,7 @@ namespace fc::vm::state {
 
   StateTreeImpl::StateTreeImpl(const std::shared_ptr<IpfsDatastore> &store,
                                const CID &root)
-      : store_{store}, by_id{root, store} {}
+      : store_{store}, by_id{root, store}, flushed_{root} {}
 
   outcome::result<void> StateTreeImpl::set(const Address &address,
                                            const Actor &actor) {
@@ -35,9 +35,15 @@ namespace fc::vm::state {
     if (address.isId()) {
       return address;
     }
+    auto it{resolved_.ids.find(address)};
+    if (it != resolved_.ids.end()) {
+      return it->second;
+    }
     OUTCOME_TRY(init_actor_state, state<InitActorState>(actor::kInitAddress));
     OUTCOME_TRY(id, init_actor_state.address_map.get(address));
-    return Address::makeFromId(id);
+    auto address_id{Address::makeFromId(id)};
+    resolved_.add(false, address, address_id);
+    return std::move(address_id);
   }
 
   outcome::result<Address> StateTreeImpl::registerNewAddress(
@@ -48,16 +54,25 @@ namespace fc::vm::state {
     OUTCOME_TRY(address_id, init_actor_state.addActor(address));
     OUTCOME_TRYA(init_actor.head, store_->setCbor(init_actor_state));
     OUTCOME_TRY(set(actor::kInitAddress, init_actor));
+    resolved_.add(false, address, address_id);
     return std::move(address_id);
   }
 
   outcome::result<CID> StateTreeImpl::flush() {
     OUTCOME_TRY(Ipld::flush(by_id));
-    return by_id.hamt.cid();
+    resolved_.pending.clear();
+    flushed_ = by_id.hamt.cid();
+    return *flushed_;
   }
 
   outcome::result<void> StateTreeImpl::revert(const CID &root) {
     by_id = {root, store_};
+    if (flushed_ == root) {
+      resolved_.revert();
+    } else {
+      resolved_ = {};
+    }
+    flushed_ = root;
     return outcome::success();
   }
 
@@ -69,4 +84,31 @@ namespace fc::vm::state {
     OUTCOME_TRY(address_id, lookupId(address));
     return by_id.remove(address_id);
   }
+
+  boost::optional<Address> StateTreeImpl::cachedKey(const Address &id) const {
+    auto it{resolved_.keys.find(id)};
+    if (it != resolved_.keys.end()) {
+      return it->second;
+    }
+    return boost::none;
+  }
+
+  void StateTreeImpl::cacheKey(const Address &id, const Address &key) {
+    resolved_.add(true, id, key);
+  }
+
+  void StateTreeImpl::Resolved::add(bool key,
+                                    const Address &from,
+                                    const Address &to) {
+    if ((key ? keys : ids).emplace(from, to).second) {
+      pending.emplace_back(key, from);
+    }
+  }
+
+  void StateTreeImpl::Resolved::revert() {
+    for (auto &[key, from] : pending) {
+      (key ? keys : ids).erase(from);
+    }
+    pending.clear();
+  }
 }  // namespace fc::vm::state
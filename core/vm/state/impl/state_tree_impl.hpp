@@ -8,6 +8,8 @@
 
 #include "vm/state/state_tree.hpp"
 
+#include <map>
+
 #include "adt/address_key.hpp"
 #include "adt/map.hpp"
 
@@ -35,9 +37,31 @@ namespace fc::vm::state {
     std::shared_ptr<IpfsDatastore> getStore() override;
     outcome::result<void> remove(const Address &address);
 
+    /// Get cached key address of id address
+    boost::optional<Address> cachedKey(const Address &id) const;
+    /// Cache key address of id address, until revert
+    void cacheKey(const Address &id, const Address &key);
+
    private:
+    /**
+     * Address resolutions of this state lineage. Init actor address map is
+     * append-only, so resolutions stay valid until revert drops addresses
+     * added after last flush.
+     */
+    struct Resolved {
+      void add(bool key, const Address &from, const Address &to);
+      /// Forget resolutions added after last flush
+      void revert();
+
+      std::map<Address, Address> ids, keys;
+      /// Resolutions added after last flush, true for keys
+      std::vector<std::pair<bool, Address>> pending;
+    };
+
     std::shared_ptr<IpfsDatastore> store_;
     adt::Map<actor::Actor, adt::AddressKeyer> by_id;
+    Resolved resolved_;
+    boost::optional<CID> flushed_;
   };
 }  // namespace fc::vm::state
 
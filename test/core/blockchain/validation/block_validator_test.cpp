@@ -9,6 +9,7 @@
 #include "blockchain/block_validator/impl/block_validator_impl.hpp"
 #include "clock/impl/chain_epoch_clock_impl.hpp"
 #include "power/impl/power_table_impl.hpp"
+#include "storage/keystore/impl/in_memory/in_memory_keystore.hpp"
 #include "testutil/literals.hpp"
 #include "testutil/mocks/blockchain/weight_calculator_mock.hpp"
 #include "testutil/mocks/clock/utc_clock_mock.hpp"
@@ -36,6 +37,10 @@ class BlockValidatorTest : public testing::Test {
   using BlsProvider = fc::crypto::bls::BlsProviderMock;
   using Secp256k1Provider = fc::crypto::secp256k1::Secp256k1ProviderMock;
   using Interpreter = fc::vm::interpreter::InterpreterMock;
+  using KeyStore = fc::storage::keystore::InMemoryKeyStore;
+  using SignatureVerifier = fc::vm::message::SignatureVerifier;
+  using BlsAggregateVerifier =
+      fc::blockchain::block_validator::BlsAggregateVerifier;
   using BlockHeader = fc::primitives::block::BlockHeader;
   using Address = fc::primitives::address::Address;
   using Ticket = fc::primitives::block::Ticket;
@@ -58,6 +63,10 @@ class BlockValidatorTest : public testing::Test {
     auto bls_provider = std::make_shared<BlsProvider>();
     auto secp_provider = std::make_shared<Secp256k1Provider>();
     auto vm_interpreter = std::make_shared<Interpreter>();
+    auto signature_verifier = std::make_shared<SignatureVerifier>(
+        std::make_shared<KeyStore>(bls_provider, secp_provider), 1);
+    auto bls_aggregate_verifier =
+        std::make_shared<BlsAggregateVerifier>(bls_provider, 1);
     return std::make_shared<BlockValidator>(datastore,
                                             utc_clock,
                                             epoch_clock,
@@ -65,7 +74,9 @@ class BlockValidatorTest : public testing::Test {
                                             power_table,
                                             bls_provider,
                                             secp_provider,
-                                            vm_interpreter);
+                                            vm_interpreter,
+                                            signature_verifier,
+                                            bls_aggregate_verifier);
   }
 
   BlockHeader getCorrectBlockHeader() const {
@@ -0,0 +1,64 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/block_validator/impl/bls_aggregate_verifier.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/literals.hpp"
+#include "testutil/mocks/crypto/bls/bls_provider_mock.hpp"
+
+namespace fc::blockchain::block_validator {
+  using crypto::bls::BlsProviderMock;
+  using testing::_;
+  using testing::Return;
+
+  class BlsAggregateVerifierTest : public ::testing::Test {
+   public:
+    std::shared_ptr<BlsProviderMock> bls_provider{
+        std::make_shared<BlsProviderMock>()};
+    BlsAggregateVerifier verifier{bls_provider, 4};
+  };
+
+  /**
+   * @given blocks without bls messages
+   * @when verify aggregates
+   * @then empty block without aggregate is valid, provider is not called
+   */
+  TEST_F(BlsAggregateVerifierTest, NoMessages) {
+    BlsAggregateVerifier::Item item;
+    EXPECT_TRUE(verifier.verify(item).valid);
+    item.cids.push_back("010001020001"_cid);
+    item.keys.emplace_back();
+    EXPECT_FALSE(verifier.verify(item).valid);
+  }
+
+  /**
+   * @given tipset blocks, one with wrong aggregate
+   * @when verify aggregates in parallel
+   * @then only wrong aggregate is invalid, time of each block is measured
+   */
+  TEST_F(BlsAggregateVerifierTest, Parallel) {
+    crypto::bls::Signature valid{}, invalid{};
+    invalid[0] = 1;
+    EXPECT_CALL(*bls_provider, verifyAggregateSignature(_, valid, _))
+        .WillRepeatedly(Return(outcome::success(true)));
+    EXPECT_CALL(*bls_provider, verifyAggregateSignature(_, invalid, _))
+        .WillRepeatedly(Return(outcome::success(false)));
+    std::vector<BlsAggregateVerifier::Item> items(5);
+    for (auto &item : items) {
+      item.cids.push_back("010001020001"_cid);
+      item.keys.emplace_back();
+      item.aggregate = valid;
+    }
+    items[2].aggregate = invalid;
+    auto results{verifier.verify(items)};
+    ASSERT_EQ(results.size(), items.size());
+    for (auto i{0u}; i < items.size(); ++i) {
+      EXPECT_EQ(results[i].valid, i != 2);
+      EXPECT_GE(results[i].time.count(), 0);
+    }
+  }
+}  // namespace fc::blockchain::block_validator
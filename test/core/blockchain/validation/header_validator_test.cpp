@@ -0,0 +1,98 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/block_validator/impl/header_validator.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::blockchain::block_validator {
+  using crypto::signature::BlsSignature;
+  using primitives::address::Address;
+  using primitives::block::BlockHeader;
+  using primitives::block::Ticket;
+
+  constexpr uint64_t kDelay{30};
+
+  class HeaderValidatorTest : public ::testing::Test {
+   public:
+    /// Creates chain from descendant to genesis, every fourth height is null
+    void SetUp() override {
+      TipsetCPtr parent;
+      uint64_t weight{0};
+      for (uint64_t height{0}; height < 20; ++height) {
+        if (height % 4 == 3) {
+          continue;
+        }
+        BlockHeader block;
+        block.miner = Address::makeFromId(1);
+        block.height = height;
+        block.timestamp = 1000 + height * kDelay;
+        block.parent_weight = weight;
+        if (parent) {
+          block.parents = parent->key.cids();
+        }
+        block.ticket = Ticket{};
+        block.election_proof.win_count = 1;
+        block.block_sig = BlsSignature{};
+        block.bls_aggregate = BlsSignature{};
+        block.beacon_entries.push_back({height + 1, {}});
+        block.parent_state_root = "010001020001"_cid;
+        block.parent_message_receipts = "010001020002"_cid;
+        block.messages = "010001020003"_cid;
+        EXPECT_OUTCOME_TRUE(ts, Tipset::create({block}));
+        chain.insert(chain.begin(), ts);
+        parent = ts;
+        weight += 10;
+      }
+    }
+
+    HeaderValidator validator{nullptr, nullptr, kDelay, 4};
+    std::vector<TipsetCPtr> chain;
+  };
+
+  /**
+   * @given valid chain
+   * @when headers are checked in parallel
+   * @then all tipsets except known base are valid
+   */
+  TEST_F(HeaderValidatorTest, Valid) {
+    auto results{validator.validate(chain, BeaconEntry{1, {}})};
+    ASSERT_EQ(results.size(), chain.size() - 1);
+    for (auto &result : results) {
+      EXPECT_TRUE(result);
+    }
+  }
+
+  /**
+   * @given tipsets with wrong timestamp, missing ticket, wrong parents and
+   * old beacon
+   * @when tipsets are checked against parents
+   * @then errors are returned
+   */
+  TEST_F(HeaderValidatorTest, Invalid) {
+    auto blocks{chain[3]->blks};
+    blocks[0].timestamp += 1;
+    EXPECT_OUTCOME_TRUE(bad1, Tipset::create(blocks));
+    EXPECT_OUTCOME_ERROR(HeaderError::kInvalidTimestamp,
+                         validator.validate(*bad1, *chain[4], boost::none));
+    blocks = chain[6]->blks;
+    blocks[0].ticket = boost::none;
+    EXPECT_OUTCOME_TRUE(bad2, Tipset::create(blocks));
+    EXPECT_OUTCOME_ERROR(HeaderError::kNoTicket,
+                         validator.validate(*bad2, *chain[7], boost::none));
+
+    // links between tipsets are checked too
+    EXPECT_OUTCOME_ERROR(HeaderError::kInvalidParents,
+                         validator.validate(*chain[2], *bad1, boost::none));
+
+    // beacon rounds must increase
+    EXPECT_OUTCOME_ERROR(
+        HeaderError::kInvalidBeacon,
+        validator.validate(*chain[0], *chain[1], BeaconEntry{100, {}}));
+  }
+}  // namespace fc::blockchain::block_validator
@@ -0,0 +1,91 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/impl/cached_weight_calculator.hpp"
+
+#include <gtest/gtest.h>
+
+#include "blockchain/impl/weight_calculator_impl.hpp"
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/blockchain/weight_calculator_mock.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::blockchain::weight::CachedWeightCalculator;
+using fc::blockchain::weight::WeightCalculatorError;
+using fc::blockchain::weight::WeightCalculatorMock;
+using fc::primitives::BigInt;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetKey;
+using fc::storage::InMemoryStorage;
+using testing::_;
+
+struct CachedWeightCalculatorTest : testing::Test {
+  /// Creates tipset of one block with given cid
+  static Tipset makeTipset(const fc::CID &cid, uint64_t height) {
+    BlockHeader block;
+    block.height = height;
+    return Tipset{TipsetKey{{cid}}, {block}};
+  }
+
+  std::shared_ptr<WeightCalculatorMock> mock{
+      std::make_shared<WeightCalculatorMock>()};
+  std::shared_ptr<InMemoryStorage> store{std::make_shared<InMemoryStorage>()};
+  Tipset ts1{makeTipset("010001020001"_cid, 1)};
+  Tipset ts2{makeTipset("010001020002"_cid, 2)};
+};
+
+/**
+ * @given weights of two heads saved by replay
+ * @when fork choice compares weights of heads
+ * @then saved weights are used, underlying calculator is not called
+ */
+TEST_F(CachedWeightCalculatorTest, ForkChoiceReadsReplayedWeights) {
+  CachedWeightCalculator calculator{mock, store};
+  EXPECT_OUTCOME_TRUE_1(calculator.setWeight(ts1.key, 20));
+  EXPECT_OUTCOME_TRUE_1(calculator.setWeight(ts2.key, 10));
+
+  EXPECT_CALL(*mock, calculateWeight(_)).Times(0);
+  EXPECT_OUTCOME_TRUE(weight1, calculator.calculateWeight(ts1));
+  EXPECT_OUTCOME_TRUE(weight2, calculator.calculateWeight(ts2));
+  EXPECT_GT(weight1, weight2);
+}
+
+/**
+ * @given calculator caching one weight
+ * @when weight evicted from cache is requested
+ * @then it is read from store, underlying calculator is not called
+ */
+TEST_F(CachedWeightCalculatorTest, EvictedWeightReadFromStore) {
+  CachedWeightCalculator calculator{mock, store, 1};
+  EXPECT_CALL(*mock, calculateWeight(_))
+      .WillOnce(testing::Return(BigInt{10}))
+      .WillOnce(testing::Return(BigInt{20}));
+  EXPECT_OUTCOME_EQ(calculator.calculateWeight(ts1), BigInt{10});
+  EXPECT_OUTCOME_EQ(calculator.calculateWeight(ts2), BigInt{20});
+
+  EXPECT_OUTCOME_EQ(calculator.calculateWeight(ts1), BigInt{10});
+  EXPECT_OUTCOME_TRUE(saved, calculator.getWeight(ts2.key));
+  EXPECT_EQ(saved, BigInt{20});
+}
+
+/**
+ * @given underlying calculator failing once
+ * @when weight is calculated
+ * @then error is returned and not persisted, next calculation retries
+ */
+TEST_F(CachedWeightCalculatorTest, ErrorNotPersisted) {
+  CachedWeightCalculator calculator{mock, store};
+  EXPECT_CALL(*mock, calculateWeight(_))
+      .WillOnce(testing::Return(WeightCalculatorError::kNoNetworkPower))
+      .WillOnce(testing::Return(BigInt{10}));
+  EXPECT_OUTCOME_ERROR(WeightCalculatorError::kNoNetworkPower,
+                       calculator.calculateWeight(ts1));
+  EXPECT_OUTCOME_TRUE(none, calculator.getWeight(ts1.key));
+  EXPECT_FALSE(none);
+
+  EXPECT_OUTCOME_EQ(calculator.calculateWeight(ts1), BigInt{10});
+}
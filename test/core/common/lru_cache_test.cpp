@@ -0,0 +1,52 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/lru_cache.hpp"
+
+#include <gtest/gtest.h>
+
+namespace fc::common {
+  /**
+   * @given cache with capacity 2
+   * @when put 3 values
+   * @then least recently used value is evicted
+   */
+  TEST(LruCacheTest, Evict) {
+    LruCache<int, int> cache{2};
+    cache.put(1, 10);
+    cache.put(2, 20);
+    EXPECT_EQ(cache.get(1), 10);
+    cache.put(3, 30);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_EQ(cache.get(1), 10);
+    EXPECT_EQ(cache.get(3), 30);
+    EXPECT_EQ(cache.get(2), boost::none);
+    EXPECT_EQ(cache.hits(), 3u);
+    EXPECT_EQ(cache.misses(), 1u);
+  }
+
+  /**
+   * @given cache with capacity by weight
+   * @when put values heavier than capacity
+   * @then values are evicted until weight fits, last value is kept
+   */
+  TEST(LruCacheTest, Weight) {
+    LruCache<int, std::string> cache{5, [](auto &s) { return s.size(); }};
+    cache.put(1, "aa");
+    cache.put(2, "bb");
+    EXPECT_EQ(cache.weight(), 4u);
+    cache.put(2, "bbb");
+    EXPECT_EQ(cache.weight(), 5u);
+    cache.put(3, "c");
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_EQ(cache.weight(), 4u);
+    cache.put(4, "dddddddd");
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_TRUE(cache.contains(4));
+    cache.erase(4);
+    EXPECT_EQ(cache.weight(), 0u);
+  }
+}  // namespace fc::common
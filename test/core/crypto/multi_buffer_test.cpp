@@ -0,0 +1,75 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "crypto/hasher/multi_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include "crypto/hasher/hasher.hpp"
+
+namespace fc::crypto::multi_buffer {
+  using libp2p::multi::HashType;
+
+  class MultiBufferTest : public ::testing::Test {
+   public:
+    void SetUp() override {
+      // lengths around sha256 and blake2b block and padding boundaries
+      for (auto size{0u}; size < 300; ++size) {
+        sizes.push_back(size);
+      }
+      sizes.insert(sizes.end(), {1000, 5000, 3, 0, 129});
+      for (auto size : sizes) {
+        std::vector<uint8_t> bytes(size);
+        for (auto i{0u}; i < size; ++i) {
+          bytes[i] = i * 7 + size;
+        }
+        data.push_back(std::move(bytes));
+      }
+      inputs.assign(data.begin(), data.end());
+    }
+
+    std::vector<size_t> sizes;
+    std::vector<std::vector<uint8_t>> data;
+    std::vector<Input> inputs;
+  };
+
+  /**
+   * @given inputs of different lengths
+   * @when hash them with SIMD kernels and with scalar fallback
+   * @then hashes are equal
+   */
+  TEST_F(MultiBufferTest, SimdMatchesScalar) {
+    std::vector<Hash256> simd(inputs.size()), scalar(inputs.size());
+    sha256(inputs, simd);
+    sha256(inputs, scalar, false);
+    EXPECT_EQ(simd, scalar);
+    blake2b_256(inputs, simd);
+    blake2b_256(inputs, scalar, false);
+    EXPECT_EQ(simd, scalar);
+  }
+
+  /**
+   * @given inputs
+   * @when hash them in batch with Hasher
+   * @then hashes equal to hashes of each input
+   */
+  TEST_F(MultiBufferTest, HasherBatch) {
+    auto sha{Hasher::calculateBatch(HashType::sha256, inputs)};
+    auto blake{Hasher::calculateBatch(HashType::blake2b_256, inputs)};
+    for (auto i{0u}; i < inputs.size(); ++i) {
+      EXPECT_EQ(sha[i], Hasher::sha2_256(inputs[i]));
+      EXPECT_EQ(blake[i], Hasher::blake2b_256(inputs[i]));
+    }
+  }
+
+  /**
+   * @given empty batch
+   * @when hash it
+   * @then nothing is hashed
+   */
+  TEST_F(MultiBufferTest, Empty) {
+    EXPECT_TRUE(Hasher::calculateBatch(HashType::blake2b_256, {}).empty());
+  }
+}  // namespace fc::crypto::multi_buffer
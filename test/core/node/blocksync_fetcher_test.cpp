@@ -0,0 +1,211 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "node/blocksync_fetcher.hpp"
+
+#include <gtest/gtest.h>
+
+#include "primitives/tipset/tipset.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/peer_id.hpp"
+
+using fc::blocksync::ChainCb;
+using fc::blocksync::Error;
+using fc::blocksync::Fetcher;
+using fc::blocksync::MessagesCb;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetCPtr;
+using fc::primitives::tipset::TipsetKey;
+using fc::storage::ipfs::InMemoryDatastore;
+
+struct BlocksyncFetcherTest : testing::Test {
+  struct HeadersRequest {
+    PeerId peer;
+    ChainCb cb;
+  };
+
+  struct MessagesRequest {
+    PeerId peer;
+    std::vector<TipsetCPtr> chain;
+    MessagesCb cb;
+  };
+
+  void SetUp() override {
+    for (uint64_t i{0}; i < 3; ++i) {
+      BlockHeader block;
+      block.height = i;
+      block.messages = remote->setCbor(i).value();
+      chain.push_back(std::make_shared<Tipset>(
+          TipsetKey{{block.messages}}, std::vector<BlockHeader>{block}));
+    }
+    fetcher = Fetcher::make(
+        [this](auto &peer, auto &, auto, auto cb) {
+          headers.push_back({peer, cb});
+        },
+        [this](auto &peer, auto &_chain, auto cb) {
+          messages.push_back({peer, _chain, cb});
+        },
+        ipld,
+        2,
+        2);
+  }
+
+  /// Replies to i-th headers request
+  void replyHeaders(size_t i, fc::outcome::result<std::vector<TipsetCPtr>> r) {
+    auto cb{headers[i].cb};
+    cb(std::move(r));
+  }
+
+  /// Replies to i-th messages request
+  void replyMessages(size_t i, fc::outcome::result<void> r) {
+    auto cb{messages[i].cb};
+    cb(std::move(r));
+  }
+
+  /// Stores messages of tipset as if they were received
+  void storeMessages(const TipsetCPtr &ts) {
+    auto &cid{ts->blks[0].messages};
+    EXPECT_OUTCOME_TRUE(value, remote->get(cid));
+    EXPECT_OUTCOME_TRUE_1(ipld->set(cid, value));
+  }
+
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  /// Store of peers, messages are copied from it
+  std::shared_ptr<InMemoryDatastore> remote{
+      std::make_shared<InMemoryDatastore>()};
+  std::vector<TipsetCPtr> chain;
+  std::shared_ptr<Fetcher> fetcher;
+  std::vector<HeadersRequest> headers;
+  std::vector<MessagesRequest> messages;
+  PeerId peer1{generatePeerId(1)}, peer2{generatePeerId(2)};
+};
+
+/**
+ * @given fetcher with window of 2 requests and two peers
+ * @when 3 requests are fetched
+ * @then 2 requests are sent to different peers, third is sent when one of
+ * them completes
+ */
+TEST_F(BlocksyncFetcherTest, Window) {
+  fetcher->addPeer(peer1);
+  fetcher->addPeer(peer2);
+  auto done{0};
+  for (auto i{0}; i < 3; ++i) {
+    fetcher->headers(chain[0]->key, 1, boost::none, [&](auto _chain) {
+      EXPECT_TRUE(_chain);
+      ++done;
+    });
+  }
+  EXPECT_EQ(headers.size(), 2u);
+  EXPECT_EQ(fetcher->inFlight(), 2u);
+  EXPECT_NE(headers[0].peer, headers[1].peer);
+
+  replyHeaders(0, chain);
+  EXPECT_EQ(done, 1);
+  EXPECT_EQ(headers.size(), 3u);
+  EXPECT_EQ(fetcher->inFlight(), 2u);
+
+  replyHeaders(1, chain);
+  replyHeaders(2, chain);
+  EXPECT_EQ(done, 3);
+  EXPECT_EQ(fetcher->inFlight(), 0u);
+}
+
+/**
+ * @given fetcher trying 2 peers
+ * @when request to preferred peer fails
+ * @then it is sent to other peer, error of last try is returned when all
+ * tries fail
+ */
+TEST_F(BlocksyncFetcherTest, RetryOtherPeer) {
+  fetcher->addPeer(peer1);
+  fetcher->addPeer(peer2);
+  boost::optional<fc::outcome::result<std::vector<TipsetCPtr>>> result;
+  auto cb{[&](auto _chain) { result = std::move(_chain); }};
+
+  fetcher->headers(chain[0]->key, 1, peer2, cb);
+  EXPECT_EQ(headers.back().peer, peer2);
+  replyHeaders(0, Error::kNotFound);
+  EXPECT_FALSE(result);
+  EXPECT_EQ(headers.back().peer, peer1);
+  replyHeaders(1, chain);
+  EXPECT_OUTCOME_TRUE_1(*result);
+
+  result.reset();
+  fetcher->headers(chain[0]->key, 1, peer1, cb);
+  replyHeaders(2, Error::kNotFound);
+  EXPECT_EQ(headers.back().peer, peer2);
+  replyHeaders(3, Error::kGoAway);
+  EXPECT_EQ(headers.size(), 4u);
+  EXPECT_OUTCOME_ERROR(Error::kGoAway, *result);
+}
+
+/**
+ * @given chain of 3 tipsets
+ * @when peer sends messages of first tipset only
+ * @then messages of rest of chain are requested again from same peer
+ */
+TEST_F(BlocksyncFetcherTest, PartialRest) {
+  fetcher->addPeer(peer1);
+  fetcher->addPeer(peer2);
+  boost::optional<fc::outcome::result<void>> result;
+  fetcher->messages(
+      chain, boost::none, [&](auto _r) { result = std::move(_r); });
+  EXPECT_EQ(messages.size(), 1u);
+  auto peer{messages[0].peer};
+
+  storeMessages(chain[0]);
+  replyMessages(0, Error::kPartial);
+  EXPECT_FALSE(result);
+  EXPECT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[1].peer, peer);
+  EXPECT_EQ(messages[1].chain,
+            std::vector<TipsetCPtr>(chain.begin() + 1, chain.end()));
+
+  replyMessages(1, fc::outcome::success());
+  EXPECT_OUTCOME_TRUE_1(*result);
+  for (auto &stats : fetcher->stats()) {
+    if (stats.peer == peer) {
+      EXPECT_EQ(stats.requests, 2u);
+      EXPECT_EQ(stats.failures, 0u);
+      EXPECT_EQ(stats.tipsets, 3u);
+    }
+  }
+}
+
+/**
+ * @given messages request
+ * @when peer replies with bad signature
+ * @then it is reported without retry
+ */
+TEST_F(BlocksyncFetcherTest, BadSignatureNotRetried) {
+  fetcher->addPeer(peer1);
+  fetcher->addPeer(peer2);
+  boost::optional<fc::outcome::result<void>> result;
+  fetcher->messages(
+      chain, boost::none, [&](auto _r) { result = std::move(_r); });
+  replyMessages(0, Error::kBadSignature);
+  EXPECT_EQ(messages.size(), 1u);
+  EXPECT_OUTCOME_ERROR(Error::kBadSignature, *result);
+}
+
+/**
+ * @given one peer
+ * @when kMaxPeerFailures requests to it fail in a row
+ * @then peer is removed
+ */
+TEST_F(BlocksyncFetcherTest, RemoveUnresponsivePeer) {
+  fetcher->addPeer(peer1);
+  for (auto i{0u}; i < Fetcher::kMaxPeerFailures; ++i) {
+    EXPECT_EQ(fetcher->stats().size(), 1u);
+    fetcher->headers(chain[0]->key, 1, boost::none, [](auto) {});
+    replyHeaders(i, Error::kNotFound);
+  }
+  EXPECT_TRUE(fetcher->stats().empty());
+  EXPECT_EQ(fetcher->inFlight(), 0u);
+}
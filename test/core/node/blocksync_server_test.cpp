@@ -0,0 +1,89 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "node/blocksync_server.hpp"
+
+#include <gtest/gtest.h>
+
+#include "primitives/tipset/tipset.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::blocksync::Error;
+using fc::blocksync::Request;
+using fc::blocksync::Response;
+using fc::blocksync::Server;
+using fc::common::Buffer;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetKey;
+using fc::storage::ipfs::InMemoryDatastore;
+
+struct BlocksyncServerTest : testing::Test {
+  void SetUp() override {
+    BlockHeader block;
+    block.height = 1;
+    tipset = std::make_shared<Tipset>(TipsetKey{{"010001020001"_cid}},
+                                      std::vector<BlockHeader>{block});
+  }
+
+  std::shared_ptr<Server> server{
+      Server::make(nullptr, std::make_shared<InMemoryDatastore>(), 1 << 20, 2)};
+  std::shared_ptr<Tipset> tipset;
+};
+
+/**
+ * @given blocksync server
+ * @when same tipset is packed twice
+ * @then second time encoded tipset is returned from cache
+ */
+TEST_F(BlocksyncServerTest, PackCache) {
+  EXPECT_OUTCOME_TRUE(bytes1, server->pack(*tipset, Request::BLOCKS));
+  EXPECT_OUTCOME_TRUE(bytes2, server->pack(*tipset, Request::BLOCKS));
+  EXPECT_EQ(bytes1.get(), bytes2.get());
+  EXPECT_FALSE(bytes1->empty());
+  auto stats{server->stats()};
+  EXPECT_EQ(stats.cache_misses, 1u);
+  EXPECT_EQ(stats.cache_hits, 1u);
+}
+
+/**
+ * @given blocksync server with rate of 2 tipsets per second
+ * @when peer requests more tipsets
+ * @then peer is limited, other peers are not
+ */
+TEST_F(BlocksyncServerTest, RateLimit) {
+  Buffer peer1{"01"_unhex}, peer2{"02"_unhex};
+  EXPECT_TRUE(server->allow(peer1, 2));
+  EXPECT_FALSE(server->allow(peer1, 1));
+  EXPECT_TRUE(server->allow(peer2, 1));
+  EXPECT_FALSE(server->allow(peer2, 3));
+  EXPECT_EQ(server->stats().rate_limited, 2u);
+}
+
+/**
+ * @given blocksync server
+ * @when response prefix is followed by encoded tipsets
+ * @then bytes equal encoded response, for short and long chains
+ */
+TEST_F(BlocksyncServerTest, EncodePrefix) {
+  EXPECT_OUTCOME_TRUE(bytes, server->pack(*tipset, Request::BLOCKS));
+  for (auto n : {0u, 1u, 23u, 24u, 300u}) {
+    EXPECT_OUTCOME_TRUE(streamed, Server::encodePrefix(Error::kPartial, n));
+    for (auto i{0u}; i < n; ++i) {
+      streamed.putBuffer(*bytes);
+    }
+    Response response{
+        std::vector<Response::Tipset>(n, Response::Tipset{tipset->blks, {}}),
+        Error::kPartial,
+        {}};
+    EXPECT_OUTCOME_TRUE(expected, fc::codec::cbor::encode(response));
+    EXPECT_EQ(streamed, expected);
+    EXPECT_OUTCOME_TRUE(decoded,
+                        fc::codec::cbor::decode<Response>(streamed));
+    EXPECT_EQ(decoded.chain.size(), n);
+  }
+}
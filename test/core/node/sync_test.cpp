@@ -0,0 +1,130 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "node/sync.hpp"
+
+#include <gtest/gtest.h>
+
+#include "crypto/bls/impl/bls_provider_impl.hpp"
+#include "crypto/secp256k1/impl/secp256k1_provider_impl.hpp"
+#include "primitives/tipset/tipset.hpp"
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "storage/keystore/impl/in_memory/in_memory_keystore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/actor/builtin/account/account_actor.hpp"
+#include "vm/message/message_util.hpp"
+#include "vm/message/signature_verifier.hpp"
+#include "vm/state/impl/state_tree_impl.hpp"
+
+using fc::CID;
+using fc::crypto::bls::BlsProviderImpl;
+using fc::crypto::secp256k1::Secp256k1ProviderImpl;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::block::MsgMeta;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetCPtr;
+using fc::storage::InMemoryStorage;
+using fc::storage::blockchain::ValidityStore;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::keystore::InMemoryKeyStore;
+using fc::sync::TsSync;
+using fc::vm::actor::Actor;
+using fc::vm::actor::kAccountCodeCid;
+using fc::vm::actor::builtin::account::AccountActorState;
+using fc::vm::message::SignatureVerifier;
+using fc::vm::message::SignedMessage;
+using fc::vm::message::UnsignedMessage;
+using fc::vm::state::StateTreeImpl;
+
+struct TsSyncTest : testing::Test {
+  void SetUp() override {
+    auto secp{std::make_shared<Secp256k1ProviderImpl>()};
+    keystore = std::make_shared<InMemoryKeyStore>(
+        std::make_shared<BlsProviderImpl>(), secp);
+    auto key{secp->generate().value()};
+    from = Address::makeSecp256k1(key.public_key);
+    EXPECT_OUTCOME_TRUE_1(keystore->put(from, key.private_key));
+
+    StateTreeImpl state_tree{ipld};
+    EXPECT_OUTCOME_TRUE(head, ipld->setCbor(AccountActorState{from}));
+    EXPECT_OUTCOME_TRUE_1(
+        state_tree.set(id, Actor{kAccountCodeCid, head, 0, 0}));
+    EXPECT_OUTCOME_TRUE(root, state_tree.flush());
+    state_root = root;
+
+    ts_sync = std::make_shared<TsSync>(
+        nullptr,
+        ipld,
+        nullptr,
+        std::make_shared<SignatureVerifier>(keystore, 1),
+        nullptr,
+        nullptr,
+        std::make_shared<ValidityStore>(std::make_shared<InMemoryStorage>()),
+        nullptr,
+        nullptr);
+  }
+
+  /// Creates tipset with one secp message sent from sender
+  TipsetCPtr makeTipset(const Address &sender,
+                        bool bad_signature,
+                        boost::optional<CID> parent_state = {}) {
+    UnsignedMessage message{Address::makeFromId(1), sender, 0, 1, 0, 1, 0, {}};
+    auto message_cid{fc::vm::message::cid(message).value()};
+    auto signature{
+        keystore->sign(from, message_cid.toBytes().value()).value()};
+    if (bad_signature) {
+      message.nonce = 1;
+    }
+    EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(SignedMessage{message, signature}));
+    MsgMeta meta;
+    ipld->load(meta);
+    EXPECT_OUTCOME_TRUE_1(meta.secp_messages.append(cid));
+    EXPECT_OUTCOME_TRUE(meta_cid, ipld->setCbor(meta));
+    BlockHeader block;
+    block.miner = Address::makeFromId(1);
+    block.height = 1;
+    block.parent_state_root = parent_state.value_or(state_root);
+    block.parent_message_receipts = "010001020001"_cid;
+    block.messages = meta_cid;
+    return Tipset::create({block}).value();
+  }
+
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<InMemoryKeyStore> keystore;
+  Address from;
+  Address id{Address::makeFromId(100)};
+  CID state_root;
+  std::shared_ptr<TsSync> ts_sync;
+};
+
+/**
+ * @given secp messages sent from id address, key of which is in parent state
+ * @when signatures of tipset are checked
+ * @then valid signature is accepted, bad signature and unknown sender are
+ * rejected
+ */
+TEST_F(TsSyncTest, SecpSignaturesIdSender) {
+  EXPECT_OUTCOME_EQ(
+      ts_sync->checkSecpSignatures(ipld, *makeTipset(id, false)), true);
+  EXPECT_OUTCOME_EQ(
+      ts_sync->checkSecpSignatures(ipld, *makeTipset(id, true)), false);
+  EXPECT_OUTCOME_EQ(ts_sync->checkSecpSignatures(
+                        ipld, *makeTipset(Address::makeFromId(101), false)),
+                    false);
+}
+
+/**
+ * @given tipset which parent state is not in store
+ * @when signatures of tipset are checked
+ * @then error is returned, tipset is not rejected
+ */
+TEST_F(TsSyncTest, SecpSignaturesMissingState) {
+  EXPECT_FALSE(ts_sync->checkSecpSignatures(
+      ipld, *makeTipset(id, false, "010001020002"_cid)));
+}
@@ -0,0 +1,92 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/tipset/ancestor_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::primitives::ChainEpoch;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::tipset::AncestorCache;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetCPtr;
+using fc::storage::ipfs::InMemoryDatastore;
+
+struct AncestorCacheTest : testing::Test {
+  /// Creates chain where every third height is null round
+  void SetUp() override {
+    TipsetCPtr parent;
+    for (uint64_t height{0}; height < 300; ++height) {
+      if (height % 3 == 2) {
+        continue;
+      }
+      BlockHeader block;
+      block.miner = Address::makeFromId(1);
+      block.height = height;
+      if (parent) {
+        block.parents = parent->key.cids();
+      }
+      block.parent_state_root = "010001020001"_cid;
+      block.parent_message_receipts = "010001020002"_cid;
+      block.messages = "010001020003"_cid;
+      EXPECT_OUTCOME_TRUE_1(ipld.setCbor(block));
+      EXPECT_OUTCOME_TRUE(ts, Tipset::create({block}));
+      chain.push_back(ts);
+      parent = ts;
+    }
+  }
+
+  /// Expected ancestor by walking parents
+  TipsetCPtr expected(ChainEpoch height) {
+    for (auto it{chain.rbegin()}; it != chain.rend(); ++it) {
+      if (static_cast<ChainEpoch>((*it)->height()) <= height) {
+        return *it;
+      }
+    }
+    return chain.front();
+  }
+
+  InMemoryDatastore ipld;
+  std::vector<TipsetCPtr> chain;
+};
+
+/**
+ * @given chain with null rounds
+ * @when ancestors at heights are requested
+ * @then highest tipset not above height is returned, loads are logarithmic
+ */
+TEST_F(AncestorCacheTest, Ancestor) {
+  AncestorCache cache;
+  auto head{chain.back()};
+  for (ChainEpoch height : {298, 297, 200, 101, 100, 3, 2, 0}) {
+    EXPECT_OUTCOME_TRUE(ancestor, cache.ancestor(ipld, head, height));
+    EXPECT_EQ(ancestor->key, expected(height)->key) << height;
+  }
+  // first lookup builds skips, next ones reuse cached tipsets
+  auto loads{cache.stats().loads};
+  EXPECT_LT(loads, chain.size());
+  EXPECT_OUTCOME_TRUE(ancestor, cache.ancestor(ipld, head, 150));
+  EXPECT_EQ(ancestor->key, expected(150)->key);
+  EXPECT_LT(cache.stats().loads - loads, 20u);
+  EXPECT_GT(cache.stats().hits, 0u);
+}
+
+/**
+ * @given cache smaller than chain
+ * @when ancestor is requested
+ * @then evicted tipsets are loaded again
+ */
+TEST_F(AncestorCacheTest, Evicted) {
+  AncestorCache cache{8};
+  EXPECT_OUTCOME_TRUE(ancestor, cache.ancestor(ipld, chain.back(), 10));
+  EXPECT_EQ(ancestor->key, expected(10)->key);
+  EXPECT_OUTCOME_TRUE(parent, cache.parent(ipld, *chain.back()));
+  EXPECT_EQ(parent->key, chain[chain.size() - 2]->key);
+}
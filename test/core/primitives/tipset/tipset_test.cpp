@@ -9,6 +9,8 @@
 #include "common/hexutil.hpp"
 #include "crypto/blake2/blake2b160.hpp"
 #include "primitives/cid/cid_of_cbor.hpp"
+#include "primitives/tipset/decoded_tipset_cache.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "testutil/cbor.hpp"
 #include "testutil/crypto/sample_signatures.hpp"
 #include "testutil/literals.hpp"
@@ -163,3 +165,37 @@ TEST_F(TipsetTest, CreateSuccess) {
   ASSERT_EQ(ts.key.cids(), ts2.key.cids());
   ASSERT_EQ(ts.blks, ts2.blks);
 }
+
+/**
+ * @given headers in store
+ * @when tipset is loaded twice
+ * @then second load returns cached tipset
+ */
+TEST_F(TipsetTest, LoadCached) {
+  fc::storage::ipfs::InMemoryDatastore ipld;
+  EXPECT_OUTCOME_TRUE_1(ipld.setCbor(bh1));
+  EXPECT_OUTCOME_TRUE_1(ipld.setCbor(bh2));
+  auto &cache{fc::primitives::tipset::decodedTipsetCache()};
+  cache.clear();
+  auto hits{cache.stats().hits};
+  EXPECT_OUTCOME_TRUE(tipset1, Tipset::load(ipld, {cid1, cid2}));
+  EXPECT_OUTCOME_TRUE(tipset2, Tipset::load(ipld, {cid1, cid2}));
+  EXPECT_EQ(tipset1, tipset2);
+  EXPECT_EQ(cache.stats().hits, hits + 1);
+  EXPECT_EQ(cache.stats().size, 1u);
+  EXPECT_GT(cache.stats().bytes, 0u);
+}
+
+/**
+ * @given tipset cached after load from one store
+ * @when tipset is loaded from other store without headers
+ * @then load fails
+ */
+TEST_F(TipsetTest, LoadCachedOtherStore) {
+  fc::storage::ipfs::InMemoryDatastore ipld, other;
+  EXPECT_OUTCOME_TRUE_1(ipld.setCbor(bh1));
+  EXPECT_OUTCOME_TRUE_1(ipld.setCbor(bh2));
+  EXPECT_OUTCOME_TRUE_1(Tipset::load(ipld, {cid1, cid2}));
+  EXPECT_OUTCOME_ERROR(fc::storage::ipfs::IpfsDatastoreError::kNotFound,
+                       Tipset::load(other, {cid1, cid2}));
+}
@@ -0,0 +1,95 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/height_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::tipset::HeadChange;
+using fc::primitives::tipset::HeadChangeType;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetCPtr;
+using fc::storage::InMemoryStorage;
+using fc::storage::blockchain::HeightIndex;
+using fc::storage::ipfs::InMemoryDatastore;
+
+struct HeightIndexTest : testing::Test {
+  /// Creates single block tipset and stores its header
+  TipsetCPtr makeTipset(uint64_t height, const TipsetCPtr &parent) {
+    BlockHeader block;
+    block.miner = Address::makeFromId(height);
+    block.height = height;
+    if (parent) {
+      block.parents = parent->key.cids();
+    }
+    block.parent_state_root = "010001020001"_cid;
+    block.parent_message_receipts = "010001020002"_cid;
+    block.messages = "010001020003"_cid;
+    return Tipset::create({block}).value();
+  }
+
+  void SetUp() override {
+    genesis = makeTipset(0, nullptr);
+    a1 = makeTipset(1, genesis);
+    // height 2 is null round
+    a3 = makeTipset(3, a1);
+    b2 = makeTipset(2, a1);
+    for (auto &ts : {genesis, a1, a3, b2}) {
+      EXPECT_OUTCOME_TRUE_1(ipld->setCbor(ts->blks[0]));
+    }
+  }
+
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<InMemoryStorage> store{std::make_shared<InMemoryStorage>()};
+  HeightIndex index{ipld, store};
+  TipsetCPtr genesis, a1, a3, b2;
+};
+
+/**
+ * @given chain with null round
+ * @when head is set
+ * @then heights are indexed, null round has no entry
+ */
+TEST_F(HeightIndexTest, Current) {
+  EXPECT_OUTCOME_TRUE_1(index.onHeadChange({HeadChangeType::CURRENT, a3}));
+  EXPECT_TRUE(index.get(0).value() == genesis->key);
+  EXPECT_TRUE(index.get(1).value() == a1->key);
+  EXPECT_FALSE(index.get(2).value());
+  EXPECT_TRUE(index.get(3).value() == a3->key);
+
+  EXPECT_OUTCOME_TRUE(ts1, index.lookup(a3, 1));
+  EXPECT_EQ(ts1->key, a1->key);
+  EXPECT_OUTCOME_TRUE(ts2, index.lookup(a3, 2));
+  EXPECT_EQ(ts2->key, a3->key);
+}
+
+/**
+ * @given indexed chain
+ * @when head is reverted and fork is applied
+ * @then heights of fork replace reverted
+ */
+TEST_F(HeightIndexTest, Reorg) {
+  EXPECT_OUTCOME_TRUE_1(index.onHeadChange({HeadChangeType::CURRENT, a3}));
+  EXPECT_OUTCOME_TRUE_1(index.onHeadChange({HeadChangeType::REVERT, a3}));
+  EXPECT_OUTCOME_TRUE_1(index.onHeadChange({HeadChangeType::APPLY, b2}));
+  EXPECT_TRUE(index.get(1).value() == a1->key);
+  EXPECT_TRUE(index.get(2).value() == b2->key);
+  EXPECT_FALSE(index.get(3).value());
+
+  // reverted branch is walked until canonical chain
+  EXPECT_OUTCOME_TRUE(ts, index.lookup(a3, 0));
+  EXPECT_EQ(ts->key, genesis->key);
+
+  HeightIndex restarted{ipld, store};
+  EXPECT_TRUE(restarted.get(2).value() == b2->key);
+}
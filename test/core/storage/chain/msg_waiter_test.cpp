@@ -0,0 +1,124 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/msg_waiter.hpp"
+
+#include <gtest/gtest.h>
+
+#include "adt/array.hpp"
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::block::MsgMeta;
+using fc::primitives::tipset::HeadChangeType;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetCPtr;
+using fc::storage::InMemoryStorage;
+using fc::storage::blockchain::MsgWaiter;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::vm::runtime::MessageReceipt;
+
+struct MsgWaiterTest : testing::Test {
+  /// Creates single block tipset and stores its header
+  TipsetCPtr makeTipset(uint64_t height,
+                        const TipsetCPtr &parent,
+                        const CID &messages,
+                        const CID &receipts) {
+    BlockHeader block;
+    block.miner = Address::makeFromId(1);
+    block.height = height;
+    if (parent) {
+      block.parents = parent->key.cids();
+    }
+    block.parent_state_root = "010001020001"_cid;
+    block.parent_message_receipts = receipts;
+    block.messages = messages;
+    EXPECT_OUTCOME_TRUE_1(ipld->setCbor(block));
+    return Tipset::create({block}).value();
+  }
+
+  void SetUp() override {
+    MsgMeta empty, meta;
+    ipld->load(empty);
+    ipld->load(meta);
+    EXPECT_OUTCOME_TRUE_1(meta.bls_messages.append(message));
+    EXPECT_OUTCOME_TRUE(empty_cid, ipld->setCbor(empty));
+    EXPECT_OUTCOME_TRUE(meta_cid, ipld->setCbor(meta));
+    fc::adt::Array<MessageReceipt> receipts{ipld};
+    EXPECT_OUTCOME_TRUE_1(receipts.append(receipt));
+    EXPECT_OUTCOME_TRUE_1(fc::Ipld::flush(receipts));
+
+    genesis = makeTipset(0, nullptr, empty_cid, "010001020002"_cid);
+    ts1 = makeTipset(1, genesis, meta_cid, "010001020002"_cid);
+    ts2 = makeTipset(2, ts1, empty_cid, receipts.amt.cid());
+    // message is included again, later inclusion is not executed
+    ts3 = makeTipset(3, ts2, meta_cid, "010001020002"_cid);
+    ts4 = makeTipset(4, ts3, empty_cid, receipts.amt.cid());
+  }
+
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<InMemoryStorage> store{std::make_shared<InMemoryStorage>()};
+  CID message{"010001020005"_cid};
+  MessageReceipt receipt{fc::vm::VMExitCode::kOk, {}, 7};
+  TipsetCPtr genesis, ts1, ts2, ts3, ts4;
+};
+
+/**
+ * @given message included in ts1, executed with receipt in ts2
+ * @when ts2 is applied and reverted
+ * @then message is found and waiter is called, then message is not found
+ */
+TEST_F(MsgWaiterTest, ApplyRevert) {
+  MsgWaiter waiter{ipld, store};
+  boost::optional<MsgWaiter::Result> waited;
+  waiter.wait(message, [&](auto &result) { waited = result; });
+  EXPECT_FALSE(waited);
+
+  EXPECT_OUTCOME_TRUE_1(waiter.onHeadChange({HeadChangeType::APPLY, ts2}));
+  ASSERT_TRUE(waited);
+  EXPECT_EQ(waited->first.gas_used, receipt.gas_used);
+  EXPECT_EQ(waited->second, ts2->key);
+  EXPECT_OUTCOME_TRUE(found, waiter.search(message));
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found->second, ts2->key);
+
+  EXPECT_OUTCOME_TRUE_1(waiter.onHeadChange({HeadChangeType::REVERT, ts2}));
+  EXPECT_OUTCOME_TRUE(reverted, waiter.search(message));
+  EXPECT_FALSE(reverted);
+}
+
+/**
+ * @given not indexed chain
+ * @when current head is set
+ * @then chain is indexed in background
+ */
+TEST_F(MsgWaiterTest, Backfill) {
+  MsgWaiter waiter{ipld, store};
+  EXPECT_OUTCOME_TRUE_1(waiter.onHeadChange({HeadChangeType::CURRENT, ts2}));
+  waiter.join();
+  EXPECT_OUTCOME_TRUE(found, waiter.search(message));
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found->second, ts2->key);
+}
+
+/**
+ * @given message included in ts1 and again in ts3
+ * @when chain is backfilled from ts4
+ * @then earliest inclusion is indexed, though it is met last
+ */
+TEST_F(MsgWaiterTest, BackfillKeepsEarliest) {
+  MsgWaiter waiter{ipld, store};
+  EXPECT_OUTCOME_TRUE_1(waiter.onHeadChange({HeadChangeType::CURRENT, ts4}));
+  waiter.join();
+  EXPECT_OUTCOME_TRUE(found, waiter.search(message));
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found->second, ts2->key);
+}
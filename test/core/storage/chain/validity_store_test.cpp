@@ -0,0 +1,45 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/validity_store.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::primitives::tipset::TipsetKey;
+using fc::storage::InMemoryStorage;
+using fc::storage::blockchain::ValidityStore;
+
+/**
+ * @given validity store with valid and invalid tipsets
+ * @when store is created again over same storage
+ * @then validities and highest valid tipset are restored
+ */
+TEST(ValidityStoreTest, Persist) {
+  auto storage{std::make_shared<InMemoryStorage>()};
+  TipsetKey key1{{"010001020001"_cid}}, key2{{"010001020002"_cid}},
+      key3{{"010001020003"_cid}}, key4{{"010001020004"_cid}};
+  EXPECT_OUTCOME_TRUE(validity, ValidityStore::create(storage, 1));
+  EXPECT_FALSE(validity->highest());
+  EXPECT_OUTCOME_TRUE_1(validity->set(key1, true, 1));
+  EXPECT_OUTCOME_TRUE_1(validity->set(key2, true, 5));
+  EXPECT_OUTCOME_TRUE_1(validity->set(key3, false, 7));
+  EXPECT_OUTCOME_TRUE_1(validity->set(key4, true, 3));
+  EXPECT_EQ(validity->highest()->height, 5u);
+
+  EXPECT_OUTCOME_TRUE(restarted, ValidityStore::create(storage, 1));
+  ASSERT_TRUE(restarted->highest());
+  EXPECT_EQ(restarted->highest()->height, 5u);
+  EXPECT_EQ(restarted->highest()->tipset, key2.cids());
+  EXPECT_OUTCOME_TRUE(valid1, restarted->get(key1));
+  EXPECT_TRUE(valid1 == true);
+  EXPECT_OUTCOME_TRUE(valid3, restarted->get(key3));
+  EXPECT_TRUE(valid3 == false);
+  EXPECT_OUTCOME_TRUE(unknown, restarted->get(TipsetKey{{"010001020005"_cid}}));
+  EXPECT_FALSE(unknown);
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::OverlayDatastore;
+using fc::storage::ipfs::OverlayPool;
+
+struct OverlayDatastoreTest : ::testing::Test {
+  std::shared_ptr<InMemoryDatastore> base{
+      std::make_shared<InMemoryDatastore>()};
+  CID cid1{"010001020001"_cid}, cid2{"010001020002"_cid};
+  Buffer value1{"01"_unhex}, value2{"02"_unhex};
+};
+
+/**
+ * @given overlay over base store
+ * @when value is written to overlay
+ * @then it is readable from overlay, but not from base
+ */
+TEST_F(OverlayDatastoreTest, WritesStayInOverlay) {
+  EXPECT_OUTCOME_TRUE_1(base->set(cid1, value1));
+  OverlayDatastore overlay{base};
+  EXPECT_OUTCOME_EQ(overlay.get(cid1), value1);
+  EXPECT_OUTCOME_TRUE_1(overlay.set(cid2, value2));
+  EXPECT_OUTCOME_EQ(overlay.get(cid2), value2);
+  EXPECT_OUTCOME_EQ(overlay.contains(cid2), true);
+  EXPECT_OUTCOME_EQ(base->contains(cid2), false);
+  EXPECT_EQ(overlay.written(), 1u);
+  overlay.reset();
+  EXPECT_EQ(overlay.written(), 0u);
+  EXPECT_OUTCOME_EQ(overlay.contains(cid2), false);
+}
+
+/**
+ * @given overlay which read value from base
+ * @when value is removed from base
+ * @then overlay still returns cached value
+ */
+TEST_F(OverlayDatastoreTest, ReadCache) {
+  EXPECT_OUTCOME_TRUE_1(base->set(cid1, value1));
+  OverlayDatastore overlay{base};
+  EXPECT_OUTCOME_EQ(overlay.get(cid1), value1);
+  EXPECT_OUTCOME_TRUE_1(base->remove(cid1));
+  EXPECT_OUTCOME_EQ(overlay.get(cid1), value1);
+}
+
+/**
+ * @given overlay pool
+ * @when overlay is released and acquired for same root
+ * @then same overlay is reused without previous writes
+ */
+TEST_F(OverlayDatastoreTest, Pool) {
+  auto pool{OverlayPool::make(base, 1, 1)};
+  auto overlay{pool->acquire(cid1)};
+  auto raw{overlay.get()};
+  EXPECT_OUTCOME_TRUE_1(overlay->set(cid2, value2));
+  overlay.reset();
+  EXPECT_EQ(pool->idle(), 1u);
+
+  overlay = pool->acquire(cid1);
+  EXPECT_EQ(overlay.get(), raw);
+  EXPECT_EQ(overlay->written(), 0u);
+  EXPECT_EQ(pool->idle(), 0u);
+
+  auto other{pool->acquire(cid2)};
+  EXPECT_NE(other.get(), raw);
+  overlay.reset();
+  other.reset();
+  // only one root is kept
+  EXPECT_EQ(pool->idle(), 1u);
+}
+
+/**
+ * @given overlay with linked blocks and unreachable block
+ * @when overlay is committed for root
+ * @then only blocks reachable from root are written to base
+ */
+TEST_F(OverlayDatastoreTest, Commit) {
+  OverlayDatastore overlay{base};
+  EXPECT_OUTCOME_TRUE(child, overlay.setCbor(std::vector<int>{1, 2}));
+  EXPECT_OUTCOME_TRUE(root, overlay.setCbor(std::vector<CID>{child}));
+  EXPECT_OUTCOME_TRUE(garbage, overlay.setCbor(std::vector<int>{3}));
+  EXPECT_OUTCOME_EQ(overlay.commit({root}), 2u);
+  EXPECT_EQ(overlay.written(), 0u);
+  EXPECT_OUTCOME_EQ(base->contains(root), true);
+  EXPECT_OUTCOME_EQ(base->contains(child), true);
+  EXPECT_OUTCOME_EQ(base->contains(garbage), false);
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/resolve.hpp"
+
+#include <gtest/gtest.h>
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::storage::ipld {
+  using codec::cbor::CborResolveError;
+  using ipfs::InMemoryDatastore;
+  using ipfs::IpfsDatastoreError;
+
+  struct Leaf {
+    std::string c;
+    uint64_t d;
+  };
+  CBOR_TUPLE(Leaf, c, d)
+
+  class IpldResolveTest : public ::testing::Test {
+   public:
+    void SetUp() override {
+      leaf = ipld->setCbor(Leaf{"leaf", 7}).value();
+      missing = common::getCidOf(codec::cbor::encode(Leaf{"x", 1}).value())
+                    .value();
+      std::map<std::string, std::vector<CID>> b{{"b", {missing, leaf}}};
+      root = ipld->setCbor(std::map<std::string, decltype(b)>{{"a", b}})
+                 .value();
+    }
+
+    std::shared_ptr<InMemoryDatastore> ipld{
+        std::make_shared<InMemoryDatastore>()};
+    CID leaf, missing, root;
+  };
+
+  /**
+   * @given object linking to other blocks, one of them missing from store
+   * @when resolve path through existing link
+   * @then raw subobject returned, missing block is never fetched
+   */
+  TEST_F(IpldResolveTest, FollowsOnlyPathLinks) {
+    EXPECT_OUTCOME_EQ(resolvePath(*ipld, root, "/a/b/1/0"),
+                      codec::cbor::encode(std::string{"leaf"}).value());
+    EXPECT_OUTCOME_EQ(resolvePath(*ipld, root, "a/b/1/1"),
+                      codec::cbor::encode(7).value());
+    EXPECT_OUTCOME_EQ(resolvePath(*ipld, root, "a/b/1"),
+                      codec::cbor::encode(leaf).value());
+  }
+
+  /**
+   * @given object with links
+   * @when resolve empty path
+   * @then root block returned
+   */
+  TEST_F(IpldResolveTest, EmptyPath) {
+    EXPECT_OUTCOME_EQ(resolvePath(*ipld, root, ""), ipld->get(root).value());
+  }
+
+  /**
+   * @given object with links
+   * @when resolve invalid paths
+   * @then errors returned
+   */
+  TEST_F(IpldResolveTest, Errors) {
+    EXPECT_OUTCOME_ERROR(CborResolveError::kKeyNotFound,
+                         resolvePath(*ipld, root, "a/c"));
+    EXPECT_OUTCOME_ERROR(CborResolveError::kKeyNotFound,
+                         resolvePath(*ipld, root, "a/b/2"));
+    EXPECT_OUTCOME_ERROR(CborResolveError::kIntKeyExpected,
+                         resolvePath(*ipld, root, "a/b/x"));
+    EXPECT_OUTCOME_ERROR(CborResolveError::kContainerExpected,
+                         resolvePath(*ipld, root, "a/b/1/1/0"));
+    EXPECT_OUTCOME_ERROR(IpfsDatastoreError::kNotFound,
+                         resolvePath(*ipld, root, "a/b/0/0"));
+  }
+}  // namespace fc::storage::ipld
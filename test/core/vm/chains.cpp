@@ -4,6 +4,8 @@
  */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
 #include <spdlog/spdlog.h>
 
 #include "storage/car/car.hpp"
@@ -12,6 +14,7 @@
 #include "testutil/read_file.hpp"
 #include "testutil/resources/resources.hpp"
 #include "vm/actor/cgo/actors.hpp"
+#include "vm/actor/cgo/metrics.hpp"
 #include "vm/interpreter/impl/interpreter_impl.hpp"
 
 using fc::primitives::StoragePower;
@@ -19,6 +22,28 @@ using fc::primitives::sector::RegisteredProof;
 using fc::primitives::tipset::Tipset;
 using fc::primitives::tipset::TipsetCPtr;
 
+/// Loads testnet chain, returns tipsets from genesis to head
+auto loadChain(
+    const std::shared_ptr<fc::storage::ipfs::InMemoryDatastore> &ipld) {
+  std::vector<TipsetCPtr> tss;
+  fc::vm::actor::cgo::config(StoragePower{1} << 20,
+                             StoragePower{10} << 40,
+                             {RegisteredProof::StackedDRG32GiBSeal,
+                              RegisteredProof::StackedDRG64GiBSeal});
+  auto car{readFile(resourcePath("testnet341.car"))};
+  auto head{fc::storage::car::loadCar(*ipld, car).value()};
+  auto ts{Tipset::load(*ipld, head).value()};
+  while (true) {
+    tss.push_back(ts);
+    if (ts->height() == 0) {
+      break;
+    }
+    ts = ts->loadParent(*ipld).value();
+  }
+  std::reverse(tss.begin(), tss.end());
+  return tss;
+}
+
 TEST(ChainsTest, Testnet_v054_h341) {
   spdlog::info("loading");
   fc::vm::actor::cgo::config(StoragePower{1} << 20,
@@ -51,5 +76,76 @@ TEST(ChainsTest, Testnet_v054_h341) {
         result, fc::vm::interpreter::InterpreterImpl{}.interpret(ipld, ts));
     last = {result.state_root, result.message_receipts};
   }
+  for (auto &stats : fc::vm::actor::cgo::crossingStats()) {
+    spdlog::info("cgo {}: {} calls, {} ns",
+                 stats.name,
+                 stats.count,
+                 stats.time.count());
+  }
+  auto null_rounds{fc::vm::interpreter::nullRoundStats()};
+  if (null_rounds.epochs != 0) {
+    spdlog::info("null round cron: {} epochs, {} ns per epoch, max {} ns",
+                 null_rounds.epochs,
+                 null_rounds.time.count() / null_rounds.epochs,
+                 null_rounds.max_time.count());
+  }
   spdlog::info("done");
 }
+
+/**
+ * Several interpreters execute tipsets concurrently over shared blockstore.
+ * Results must match chain.
+ */
+TEST(ChainsTest, ParallelInterpreters) {
+  auto ipld{std::make_shared<fc::storage::ipfs::InMemoryDatastore>()};
+  auto tss{loadChain(ipld)};
+  constexpr size_t kThreads{4};
+  std::atomic_size_t next{0}, mismatch{0}, failed{0};
+  std::vector<std::thread> threads;
+  for (auto i{0u}; i < kThreads; ++i) {
+    threads.emplace_back([&] {
+      fc::vm::interpreter::InterpreterImpl vmi;
+      for (auto j{next++}; j + 1 < tss.size(); j = next++) {
+        auto result{vmi.interpret(ipld, tss[j])};
+        if (!result) {
+          ++failed;
+        } else if (result.value().state_root
+                       != tss[j + 1]->getParentStateRoot()
+                   || result.value().message_receipts
+                          != tss[j + 1]->getParentMessageReceipts()) {
+          ++mismatch;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(failed.load(), 0u);
+  EXPECT_EQ(mismatch.load(), 0u);
+}
+
+/**
+ * Chain segment is replayed with one state tree.
+ * Results must match chain, persisted states must be in blockstore.
+ */
+TEST(ChainsTest, Replay) {
+  auto ipld{std::make_shared<fc::storage::ipfs::InMemoryDatastore>()};
+  auto tss{loadChain(ipld)};
+  std::vector<TipsetCPtr> segment{tss.begin() + 1, tss.end()};
+  EXPECT_OUTCOME_TRUE(
+      replay, fc::vm::interpreter::InterpreterImpl{}.replay(ipld, segment, 16));
+  ASSERT_EQ(replay.results.size(), segment.size());
+  for (auto i{0u}; i + 1 < segment.size(); ++i) {
+    EXPECT_EQ(replay.results[i].state_root,
+              segment[i + 1]->getParentStateRoot());
+    EXPECT_EQ(replay.results[i].message_receipts,
+              segment[i + 1]->getParentMessageReceipts());
+  }
+  ASSERT_FALSE(replay.persisted.empty());
+  EXPECT_EQ(replay.persisted.back(), segment.size() - 1);
+  for (auto i : replay.persisted) {
+    EXPECT_OUTCOME_EQ(ipld->contains(replay.results[i].state_root), true);
+  }
+  spdlog::info("replayed {} tipsets/sec", replay.tipsetsPerSecond());
+}
@@ -0,0 +1,127 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/interpreter/impl/interpreter_impl.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/ipfs/ipfs_datastore_error.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/vm/interpreter/interpreter_mock.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::primitives::block::BlockHeader;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetKey;
+using fc::storage::InMemoryStorage;
+using fc::vm::interpreter::CachedInterpreter;
+using fc::vm::interpreter::InterpreterMock;
+using fc::vm::interpreter::Result;
+using testing::_;
+
+struct CachedInterpreterTest : testing::Test {
+  void SetUp() override {
+    BlockHeader block;
+    block.height = 1;
+    tipset = std::make_shared<Tipset>(TipsetKey{{"010001020001"_cid}},
+                                      std::vector<BlockHeader>{block});
+  }
+
+  std::shared_ptr<InterpreterMock> mock{std::make_shared<InterpreterMock>()};
+  std::shared_ptr<InMemoryStorage> store{std::make_shared<InMemoryStorage>()};
+  CachedInterpreter interpreter{mock, store};
+  fc::primitives::tipset::TipsetCPtr tipset;
+  Result result{"010001020002"_cid, "010001020003"_cid};
+};
+
+/**
+ * @given cached interpreter
+ * @when tipset is interpreted twice
+ * @then interpreter is called once and result is persisted
+ */
+TEST_F(CachedInterpreterTest, Cache) {
+  EXPECT_CALL(*mock, interpret(_, tipset)).WillOnce(testing::Return(result));
+  EXPECT_OUTCOME_TRUE(result1, interpreter.interpret(nullptr, tipset));
+  EXPECT_OUTCOME_TRUE(result2, interpreter.interpret(nullptr, tipset));
+  EXPECT_EQ(result1.state_root, result.state_root);
+  EXPECT_EQ(result2.message_receipts, result.message_receipts);
+  EXPECT_OUTCOME_TRUE(saved,
+                      fc::vm::interpreter::getSavedResult(*store, tipset));
+  EXPECT_TRUE(saved);
+
+  CachedInterpreter restarted{mock, store};
+  EXPECT_OUTCOME_TRUE(result3, restarted.interpret(nullptr, tipset));
+  EXPECT_EQ(result3.state_root, result.state_root);
+}
+
+/**
+ * @given cached interpreter
+ * @when tipset is interpreted concurrently
+ * @then all callers share one execution
+ */
+TEST_F(CachedInterpreterTest, SingleFlight) {
+  std::promise<void> entered, release;
+  EXPECT_CALL(*mock, interpret(_, tipset))
+      .WillOnce(testing::Invoke([&](auto, auto) {
+        entered.set_value();
+        release.get_future().wait();
+        return result;
+      }));
+  std::vector<std::thread> threads;
+  std::atomic_size_t ok{0};
+  for (auto i{0}; i < 3; ++i) {
+    threads.emplace_back([&] {
+      auto _result{interpreter.interpret(nullptr, tipset)};
+      if (_result && _result.value().state_root == result.state_root) {
+        ++ok;
+      }
+    });
+  }
+  entered.get_future().wait();
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  release.set_value();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(ok.load(), 3u);
+}
+
+/**
+ * @given cached interpreter
+ * @when interpretation fails due to missing store data
+ * @then failure is not persisted and tipset is interpreted again
+ */
+TEST_F(CachedInterpreterTest, MissingDataNotCached) {
+  EXPECT_CALL(*mock, interpret(_, tipset))
+      .WillOnce(testing::Return(
+          fc::storage::ipfs::IpfsDatastoreError::kNotFound))
+      .WillOnce(testing::Return(result));
+  EXPECT_OUTCOME_FALSE_1(interpreter.interpret(nullptr, tipset));
+  EXPECT_OUTCOME_TRUE(saved,
+                      fc::vm::interpreter::getSavedResult(*store, tipset));
+  EXPECT_FALSE(saved);
+  EXPECT_OUTCOME_TRUE(result2, interpreter.interpret(nullptr, tipset));
+  EXPECT_EQ(result2.state_root, result.state_root);
+}
+
+/**
+ * @given cached interpreter
+ * @when interpretation fails by consensus rules
+ * @then failure is persisted and tipset is not interpreted again
+ */
+TEST_F(CachedInterpreterTest, ConsensusFailureCached) {
+  using fc::vm::interpreter::InterpreterError;
+  EXPECT_CALL(*mock, interpret(_, tipset))
+      .WillOnce(testing::Return(InterpreterError::kCronTickFailed));
+  EXPECT_OUTCOME_ERROR(InterpreterError::kCronTickFailed,
+                       interpreter.interpret(nullptr, tipset));
+  CachedInterpreter restarted{mock, store};
+  EXPECT_OUTCOME_ERROR(InterpreterError::kTipsetMarkedBad,
+                       restarted.interpret(nullptr, tipset));
+}
@@ -0,0 +1,143 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/message/signature_verifier.hpp"
+
+#include <gtest/gtest.h>
+
+#include "crypto/bls/impl/bls_provider_impl.hpp"
+#include "crypto/secp256k1/impl/secp256k1_provider_impl.hpp"
+#include "storage/keystore/impl/in_memory/in_memory_keystore.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/message/impl/message_signer_impl.hpp"
+#include "vm/message/message_util.hpp"
+
+namespace fc::vm::message {
+  using crypto::bls::BlsProviderImpl;
+  using crypto::secp256k1::Secp256k1ProviderImpl;
+  using storage::keystore::InMemoryKeyStore;
+
+  class SignatureVerifierTest : public ::testing::Test {
+   public:
+    void SetUp() override {
+      auto secp{std::make_shared<Secp256k1ProviderImpl>()};
+      keystore = std::make_shared<InMemoryKeyStore>(
+          std::make_shared<BlsProviderImpl>(), secp);
+      auto key{secp->generate().value()};
+      from = Address::makeSecp256k1(key.public_key);
+      EXPECT_OUTCOME_TRUE_1(keystore->put(from, key.private_key));
+      MessageSignerImpl signer{keystore};
+      for (auto nonce{0u}; nonce < 20; ++nonce) {
+        UnsignedMessage message{
+            Address::makeFromId(1), from, nonce, 1, 0, 1, 0, {}};
+        EXPECT_OUTCOME_TRUE(signed_message, signer.sign(from, message));
+        EXPECT_OUTCOME_TRUE(item,
+                            SignatureVerifier::item(signed_message, {}));
+        items.push_back(std::move(*item));
+      }
+    }
+
+    std::shared_ptr<InMemoryKeyStore> keystore;
+    Address from;
+    std::vector<SignatureVerifier::Item> items;
+  };
+
+  /**
+   * @given batch of signed messages, one of them with wrong signature
+   * @when verify batch on thread pool
+   * @then bitmap marks only wrong signature as invalid and metrics are counted
+   */
+  TEST_F(SignatureVerifierTest, Batch) {
+    SignatureVerifier verifier{keystore, 4};
+    std::swap(items[3].signature, items[5].signature);
+    std::vector<bool> expected(items.size(), true);
+    expected[3] = expected[5] = false;
+    EXPECT_EQ(verifier.verify(items), expected);
+    EXPECT_TRUE(verifier.verify(items[0]));
+    EXPECT_FALSE(verifier.verify(items[3]));
+
+    auto metrics{verifier.metrics()};
+    EXPECT_EQ(metrics.batches, 1u);
+    EXPECT_EQ(metrics.signatures, items.size());
+    EXPECT_EQ(metrics.invalid, 2u);
+  }
+
+  /**
+   * @given batch verified once
+   * @when verify same batch again
+   * @then valid signatures are taken from cache, invalid are verified again
+   */
+  TEST_F(SignatureVerifierTest, Cache) {
+    SignatureVerifier verifier{keystore, 4};
+    std::swap(items[3].signature, items[5].signature);
+    auto expected{verifier.verify(items)};
+    EXPECT_EQ(verifier.metrics().cache_hits, 0u);
+    EXPECT_EQ(verifier.verify(items), expected);
+    EXPECT_EQ(verifier.metrics().cache_hits, items.size() - 2);
+    EXPECT_FALSE(verifier.verify(items[3]));
+  }
+
+  /**
+   * @given message signed by key of sender with id address
+   * @when item is made with resolver of sender
+   * @then signature is checked against resolved key address, unresolved
+   * sender is skipped
+   */
+  TEST_F(SignatureVerifierTest, IdSender) {
+    auto id{Address::makeFromId(100)};
+    UnsignedMessage message{Address::makeFromId(1), id, 0, 1, 0, 1, 0, {}};
+    EXPECT_OUTCOME_TRUE(message_cid, cid(message));
+    EXPECT_OUTCOME_TRUE(message_bytes, message_cid.toBytes());
+    EXPECT_OUTCOME_TRUE(signature, keystore->sign(from, message_bytes));
+    SignedMessage signed_message{message, signature};
+    SignatureVerifier verifier{keystore, 4};
+
+    EXPECT_OUTCOME_TRUE(item,
+                        SignatureVerifier::item(
+                            signed_message, [&](auto &address) {
+                              return address == id
+                                         ? boost::make_optional(from)
+                                         : boost::none;
+                            }));
+    ASSERT_TRUE(item);
+    EXPECT_EQ(item->address, from);
+    EXPECT_TRUE(verifier.verify(*item));
+
+    EXPECT_OUTCOME_TRUE(unresolved,
+                        SignatureVerifier::item(
+                            signed_message,
+                            [](auto &) -> boost::optional<Address> {
+                              return boost::none;
+                            }));
+    EXPECT_FALSE(unresolved);
+  }
+
+  /**
+   * @given id sender resolved to key of signer in one state
+   * @when same message and signature are verified with sender resolved to
+   * other key
+   * @then cached result is not reused and signature is invalid
+   */
+  TEST_F(SignatureVerifierTest, CacheKeyAddress) {
+    SignatureVerifier verifier{keystore, 4};
+    std::vector<SignatureVerifier::Item> batch{items[0]};
+    EXPECT_EQ(verifier.verify(batch), std::vector<bool>{true});
+    auto other{Secp256k1ProviderImpl{}.generate().value()};
+    batch[0].address = Address::makeSecp256k1(other.public_key);
+    EXPECT_EQ(verifier.verify(batch), std::vector<bool>{false});
+    EXPECT_EQ(verifier.metrics().cache_hits, 0u);
+  }
+
+  /**
+   * @given empty batch
+   * @when verify batch
+   * @then empty bitmap returned
+   */
+  TEST_F(SignatureVerifierTest, Empty) {
+    SignatureVerifier verifier{keystore, 4};
+    EXPECT_TRUE(verifier.verify(gsl::span<const SignatureVerifier::Item>{})
+                    .empty());
+  }
+}  // namespace fc::vm::message
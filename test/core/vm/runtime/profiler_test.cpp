@@ -0,0 +1,100 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/profiler.hpp"
+
+#include <gtest/gtest.h>
+#include "testutil/literals.hpp"
+#include "vm/message/message.hpp"
+
+using fc::primitives::address::Address;
+using fc::vm::message::UnsignedMessage;
+using fc::vm::runtime::EnvProfile;
+using fc::vm::runtime::Profiler;
+
+/**
+ * @given message calling actor method with nested call
+ * @when profile is added to profiler
+ * @then resources are attributed to methods, message and tipset
+ */
+TEST(Profiler, NestedCalls) {
+  auto code1{"010001020001"_cid}, code2{"010001020002"_cid};
+  UnsignedMessage message;
+  message.from = Address::makeFromId(100);
+  message.to = Address::makeFromId(101);
+  message.method = 2;
+
+  EnvProfile profile{7};
+  profile.beginMessage(message);
+  profile.charge(5);
+  profile.enter(code1, 2);
+  profile.charge(10);
+  profile.get(3);
+  profile.enter(code2, 3);
+  profile.charge(20);
+  profile.put(4);
+  profile.leave();
+  profile.leave();
+  profile.endMessage();
+
+  Profiler profiler;
+  profiler.add(std::move(profile));
+
+  auto methods{profiler.methods()};
+  ASSERT_EQ(methods.size(), 2u);
+  for (auto &method : methods) {
+    EXPECT_EQ(method.stats.calls, 1u);
+    EXPECT_LE(method.stats.self_time, method.stats.time);
+    if (method.code == code1) {
+      EXPECT_EQ(method.method, 2u);
+      EXPECT_EQ(method.stats.gas, 10);
+      EXPECT_EQ(method.stats.gets, 1u);
+      EXPECT_EQ(method.stats.get_bytes, 3u);
+      EXPECT_EQ(method.stats.puts, 0u);
+    } else {
+      EXPECT_EQ(method.code, code2);
+      EXPECT_EQ(method.method, 3u);
+      EXPECT_EQ(method.stats.gas, 20);
+      EXPECT_EQ(method.stats.gets, 0u);
+      EXPECT_EQ(method.stats.puts, 1u);
+      EXPECT_EQ(method.stats.put_bytes, 4u);
+    }
+  }
+
+  auto tipsets{profiler.tipsets()};
+  ASSERT_EQ(tipsets.size(), 1u);
+  EXPECT_EQ(tipsets[0].height, 7);
+  EXPECT_EQ(tipsets[0].stats.gas, 35);
+  ASSERT_EQ(tipsets[0].messages.size(), 1u);
+  auto &stats{tipsets[0].messages[0].stats};
+  EXPECT_EQ(tipsets[0].messages[0].to, message.to);
+  EXPECT_EQ(stats.gas, 35);
+  EXPECT_EQ(stats.gets, 1u);
+  EXPECT_EQ(stats.puts, 1u);
+}
+
+/**
+ * @given profiler keeping 2 tipsets
+ * @when 3 tipsets are added
+ * @then oldest is dropped, methods are aggregated over all
+ */
+TEST(Profiler, MaxTipsets) {
+  Profiler profiler{2};
+  for (auto height : {1, 2, 3}) {
+    EnvProfile profile{height};
+    profile.enter("010001020001"_cid, 1);
+    profile.leave();
+    profiler.add(std::move(profile));
+  }
+  auto tipsets{profiler.tipsets()};
+  ASSERT_EQ(tipsets.size(), 2u);
+  EXPECT_EQ(tipsets[0].height, 2);
+  EXPECT_EQ(tipsets[1].height, 3);
+  auto methods{profiler.methods()};
+  ASSERT_EQ(methods.size(), 1u);
+  EXPECT_EQ(methods[0].stats.calls, 3u);
+  profiler.clear();
+  EXPECT_TRUE(profiler.methods().empty());
+}
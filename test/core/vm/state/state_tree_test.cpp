@@ -75,3 +75,24 @@ TEST_F(StateTreeTest, RegisterNewAddressLookupId) {
   EXPECT_OUTCOME_EQ(tree->registerNewAddress(address), kAddressId);
   EXPECT_OUTCOME_EQ(tree->lookupId(address), kAddressId);
 }
+
+/**
+ * @given State tree with registered address
+ * @when Revert to state before registration
+ * @then Cached resolution is dropped with reverted registration
+ */
+TEST_F(StateTreeTest, RegisterNewAddressRevert) {
+  auto tree = setupInitActor(nullptr, 13);
+  EXPECT_OUTCOME_TRUE(root, tree->flush());
+  Address address{fc::primitives::address::TESTNET,
+                  fc::primitives::address::ActorExecHash{}};
+  EXPECT_OUTCOME_EQ(tree->registerNewAddress(address), kAddressId);
+  EXPECT_OUTCOME_EQ(tree->lookupId(address), kAddressId);
+  EXPECT_OUTCOME_TRUE_1(tree->revert(root));
+  EXPECT_OUTCOME_FALSE_1(tree->lookupId(address));
+
+  EXPECT_OUTCOME_EQ(tree->registerNewAddress(address), kAddressId);
+  EXPECT_OUTCOME_TRUE(root2, tree->flush());
+  EXPECT_OUTCOME_TRUE_1(tree->revert(root2));
+  EXPECT_OUTCOME_EQ(tree->lookupId(address), kAddressId);
+}
@@ -25,6 +25,12 @@ namespace fc::crypto::bls {
                        outcome::result<bool>(gsl::span<const uint8_t>,
                                              const Signature &,
                                              const PublicKey &));
+    MOCK_CONST_METHOD3(
+        verifyAggregateSignature,
+        outcome::result<bool>(gsl::span<const gsl::span<const uint8_t>>,
+                              const Signature &,
+                              gsl::span<const PublicKey>));
+
     MOCK_CONST_METHOD1(
         aggregateSignatures,
         outcome::result<Signature>(gsl::span<const Signature>));